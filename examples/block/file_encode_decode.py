@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+# encoding: utf-8
+
+# License for Commercial Usage
+# Distributed under the "KODO EVALUATION LICENSE 1.3"
+# Licensees holding a valid commercial license may use this project in
+# accordance with the standard license agreement terms provided with the
+# Software (see accompanying file LICENSE.rst or
+# https://www.steinwurf.com/license), unless otherwise different terms and
+# conditions are agreed in writing between Licensee and Steinwurf ApS in which
+# case the license will be regulated by that separate written agreement.
+# License for Non-Commercial Usage
+# Distributed under the "KODO RESEARCH LICENSE 1.2"
+# Licensees holding a valid research license may use this project in accordance
+# with the license agreement terms provided with the Software
+# See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+import os
+import random
+import tempfile
+
+import kodo
+
+
+def main():
+    """
+    Example showing how to encode a file split into generations and decode it
+    straight into another file, with the generations coded in parallel.
+    """
+
+    field = kodo.FiniteField.binary8
+
+    # Each generation contains symbols * symbol_bytes bytes of the file
+    symbols = 64
+    symbol_bytes = 1400
+
+    with tempfile.TemporaryDirectory() as directory:
+
+        # Create a file spanning a few generations
+        input_path = os.path.join(directory, "input")
+        with open(input_path, "wb") as f:
+            f.write(os.urandom(10 * symbols * symbol_bytes + 1000))
+
+        encoder = kodo.block.FileEncoder(input_path, field, symbols, symbol_bytes)
+
+        # The receiver must know the size of the file
+        output_path = os.path.join(directory, "output")
+        decoder = kodo.block.FileDecoder(
+            output_path, field, symbols, symbol_bytes, encoder.file_bytes
+        )
+
+        print(
+            f"{encoder.file_bytes} bytes in {encoder.generations} generations "
+            f"using {encoder.threads} threads"
+        )
+
+        # Lose packets with 10% probability
+        loss_probability = 10
+        packet_bytes = encoder.packet_bytes
+
+        while not decoder.is_complete():
+
+            # Encode 16 packets for every generation in one call
+            packets = encoder.encode_packets(16)
+
+            received = bytearray()
+            for offset in range(0, len(packets), packet_bytes):
+                if random.randint(0, 100) >= loss_probability:
+                    received += packets[offset : offset + packet_bytes]
+
+            for generation in decoder.decode_packets(received):
+                print(f"generation {generation} decoded")
+
+        decoder.flush()
+        del decoder
+
+        with open(input_path, "rb") as f:
+            data_in = f.read()
+        with open(output_path, "rb") as f:
+            data_out = f.read()
+
+    if data_in == data_out:
+        print("Decoding was successful. Yay!")
+    else:
+        print("Data was not decoded correctly. Something went wrong")
+
+
+if __name__ == "__main__":
+    main()
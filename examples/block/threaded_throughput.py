@@ -0,0 +1,119 @@
+#!/usr/bin/env python
+# encoding: utf-8
+
+# License for Commercial Usage
+# Distributed under the "KODO EVALUATION LICENSE 1.3"
+# Licensees holding a valid commercial license may use this project in
+# accordance with the standard license agreement terms provided with the
+# Software (see accompanying file LICENSE.rst or
+# https://www.steinwurf.com/license), unless otherwise different terms and
+# conditions are agreed in writing between Licensee and Steinwurf ApS in which
+# case the license will be regulated by that separate written agreement.
+# License for Non-Commercial Usage
+# Distributed under the "KODO RESEARCH LICENSE 1.2"
+# Licensees holding a valid research license may use this project in accordance
+# with the license agreement terms provided with the Software
+# See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+"""
+Benchmark of independent block coders running in Python threads.
+
+The GIL is released while encoding and decoding, so the throughput should
+grow with the number of threads up to the number of cores. The throughput
+and the speedup over a single thread are printed for 1, 2, 4, ... threads.
+"""
+
+import os
+import sys
+import threading
+import time
+
+import kodo
+
+
+def encode_decode(field, symbols, symbol_bytes, generations):
+    """Encode and decode a number of generations with a private set of
+    coders. Return True if all generations were decoded correctly."""
+
+    encoder = kodo.block.Encoder(field)
+    decoder = kodo.block.Decoder(field)
+    generator = kodo.block.generator.RandomUniform(field)
+
+    for generation in range(generations):
+        encoder.configure(symbols, symbol_bytes)
+        decoder.configure(symbols, symbol_bytes)
+        generator.configure(symbols)
+        generator.set_seed(generation)
+
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        while not decoder.is_complete():
+            coefficients = generator.generate()
+            symbol = encoder.encode_symbol(coefficients)
+            decoder.decode_symbol(symbol, coefficients)
+
+        if data_in != data_out:
+            return False
+
+    return True
+
+
+def run_threads(threads, field, symbols, symbol_bytes, generations):
+    """Run one coding session per thread and return the elapsed time in
+    seconds."""
+
+    results = [False] * threads
+
+    def session(index):
+        results[index] = encode_decode(field, symbols, symbol_bytes, generations)
+
+    workers = [
+        threading.Thread(target=session, args=(index,)) for index in range(threads)
+    ]
+
+    start = time.perf_counter()
+    for worker in workers:
+        worker.start()
+    for worker in workers:
+        worker.join()
+    elapsed = time.perf_counter() - start
+
+    if not all(results):
+        raise RuntimeError("Decoding failed")
+    return elapsed
+
+
+def main():
+
+    field = kodo.FiniteField.binary8
+    symbols = 64
+    symbol_bytes = 16384
+    generations = 4
+    max_threads = min(os.cpu_count() or 1, 16)
+
+    if "--dry-run" in sys.argv:
+        symbol_bytes = 1024
+        generations = 1
+        max_threads = min(max_threads, 2)
+
+    block_bytes = symbols * symbol_bytes * generations
+
+    single = run_threads(1, field, symbols, symbol_bytes, generations)
+    print(f"{'threads':>8} {'MB/s':>10} {'speedup':>8}")
+    print(f"{1:>8} {block_bytes / single / 1e6:>10.1f} {1.0:>8.2f}")
+
+    threads = 2
+    while threads <= max_threads:
+        elapsed = run_threads(threads, field, symbols, symbol_bytes, generations)
+        throughput = threads * block_bytes / elapsed
+        speedup = threads * single / elapsed
+        print(f"{threads:>8} {throughput / 1e6:>10.1f} {speedup:>8.2f}")
+        threads *= 2
+
+
+if __name__ == "__main__":
+    main()
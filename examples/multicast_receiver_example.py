@@ -73,50 +73,22 @@ def main():
 
     sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
 
-    decoder = None
-    generator = None
+    # The depacketizer configures its decoder from the packet headers.
+    depacketizer = kodo.perpetual.Depacketizer()
 
     print("Processing...")
     while True:
         time.sleep(0.2)
         packet = sock.recv(10240)
 
-        header_data = packet
-        symbol = bytearray(packet[27:])
+        if depacketizer.decode_packet(packet):
+            print(f"Decoder rank: {depacketizer.rank}/{depacketizer.symbols}")
 
-        seed, offset, width_byte, block_bytes, symbol_bytes, width = struct.unpack_from(
-            "<QQBIIH", header_data
-        )
-        print(seed, offset, width_byte, block_bytes, symbol_bytes)
-        width = kodo.perpetual.Width.from_value(width_byte)
-
-        if (
-            decoder is None
-            or width != decoder.width
-            or block_bytes != decoder.block_bytes
-            or symbol_bytes != decoder.symbol_bytes
-        ):
-            decoder = kodo.perpetual.Decoder(width)
-            decoder.configure(block_bytes, symbol_bytes)
-            data_out = bytearray(decoder.block_bytes)
-            decoder.set_symbols_storage(data_out)
-
-        if generator is None:
-            generator = kodo.perpetual.generator.RandomUniform(decoder.width)
-
-        coefficients = generator.generate(seed)
-
-        old_rank = decoder.rank
-        decoder.decode_symbol(symbol, coefficients, offset)
-
-        if decoder.rank != old_rank:
-            print(f"Decoder rank: {decoder.rank}/{decoder.symbols}")
-
-        if decoder.is_complete():
+        if depacketizer.is_complete():
             break
 
     f = open(args.output_file, "wb")
-    f.write(data_out)
+    f.write(depacketizer.data)
     f.close()
 
     print("Processing finished.")
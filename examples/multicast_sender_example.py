@@ -19,10 +19,8 @@ import argparse
 import kodo
 import os
 import socket
-import struct
 import sys
 import time
-import random
 
 MCAST_GRP = "224.1.1.1"
 MCAST_PORT = 5007
@@ -70,17 +68,11 @@ def main():
     block_bytes = file_stats.st_size
 
     symbol_bytes = 1400
-    symbols = block_bytes // symbol_bytes + 1
     width = kodo.perpetual.Width._8
 
-    # Create and configure the encoder, coefficient generator and offset generator.
-    encoder = kodo.perpetual.Encoder(width)
-    encoder.configure(block_bytes, symbol_bytes)
-
-    generator = kodo.perpetual.generator.RandomUniform(width)
-
-    offset_generator = kodo.perpetual.offset.RandomUniform()
-    offset_generator.configure(symbols)
+    # Create the packetizer, which owns the encoder, coefficient generator
+    # and offset generator, and writes complete packets.
+    packetizer = kodo.perpetual.Packetizer(width, block_bytes, symbol_bytes)
 
     sock = socket.socket(
         family=socket.AF_INET, type=socket.SOCK_DGRAM, proto=socket.IPPROTO_UDP
@@ -92,46 +84,28 @@ def main():
     # can fit into a single generation. No more data will be sent.
     # If the file is smaller than block_bytes then it will be zero-padded.
     f = open(os.path.expanduser(args.file_path), "rb")
-    data_in = bytearray(f.read().ljust(encoder.block_bytes))
+    data_in = bytearray(f.read().ljust(packetizer.block_bytes))
     f.close()
 
     # Assign the data_in buffer to the encoder symbol_storage.
-    encoder.set_symbols_storage(data_in)
+    packetizer.set_symbols_storage(data_in)
 
     if args.dry_run:
         sys.exit(0)
 
     address = (args.ip, args.port)
 
-    header_data = bytearray(27)
+    # The packet buffer is reused for every packet.
+    packet = bytearray(packetizer.packet_bytes)
 
     print("Processing...")
     while True and not args.dry_run:
 
         time.sleep(0.2)
 
-        # Generate an encoded packet.
-        seed = random.randint(0, 2 ** 64 - 1)
-
-        offset = offset_generator.offset()
-        coefficients = generator.generate(seed)
-
-        symbol = encoder.encode_symbol(coefficients, offset)
-
-        struct.pack_into(
-            "<QQBIIH",
-            header_data,
-            0,
-            seed,
-            offset,
-            width.value,
-            block_bytes,
-            symbol_bytes,
-            width,
-        )
+        # Generate an encoded packet with the seed and offset in its header.
+        packetizer.write_packet(packet)
 
-        # Send the encoded packet with seed and offset.
-        packet = header_data + symbol
         sock.sendto(packet, address)
         print("Packet sent!")
 
@@ -40,10 +40,9 @@ def main():
 
     rate = kodo.slide.RateController(n=10, k=4)
 
-    # Keeping track of decoded symbols
-    decoded = []
-
-    decoder.on_symbol_decoded(lambda index: decoded.append(index))
+    # Deliver the decoded symbols in order, skipping a missing symbol when
+    # it holds back more than half of the decoder's capacity
+    decoder.configure_delivery(max_gap=decoder_capacity // 2)
 
     # Lose packets with 10% probability
     loss_probability = 10
@@ -97,12 +96,9 @@ def main():
         #         slide its window/stream - dropping symbols that are
         #         now too "old".
 
-        # Check if the decoder's stream is behind the encoder
-        while decoder.stream_upper_bound < encoder.stream_upper_bound:
-            if decoder.stream_symbols >= decoder_capacity:
-                # Remove the "oldest" symbol
-                decoder.pop_symbol()
-            decoder.push_symbol()
+        # Catch up with the encoder's stream, removing the "oldest"
+        # symbols when the decoder is at maximum capacity
+        decoder.advance_to(encoder.stream_upper_bound, decoder_capacity)
 
         if repair:
 
@@ -116,26 +112,16 @@ def main():
             index += 1
 
         # New symbols may now be decoded.
-        for i in range(decoder.stream_symbols):
-
-            index = i + decoder.stream_lower_bound
-
-            if not decoder.is_symbol_decoded(index):
-                # This symbol has not yet been decoded
-                continue
-            if index in decoded:
-                continue
-            decoded.append(index)
-            if decoder.in_stream(index) and encoder.in_stream(index):
-                # If symbol is available on both the encoder and decoder,
-                # check that they do indeed contain the same data.
-                data_out = decoder.symbol_data(index)
-                data_in = encoder.symbol_data(index)
+        for decoded_index, data_out in decoder.deliver_symbols():
+            if encoder.in_stream(decoded_index):
+                # If symbol is still available on the encoder, check that
+                # they do indeed contain the same data.
+                data_in = encoder.symbol_data(decoded_index)
 
                 if data_in == data_out:
-                    print(f" decoded {index}!")
+                    print(f" decoded {decoded_index}!")
                 else:
-                    print(f" decoding failed {index}!")
+                    print(f" decoding failed {decoded_index}!")
                     sys.exit(1)
 
 
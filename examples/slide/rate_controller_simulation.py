@@ -0,0 +1,156 @@
+#!/usr/bin/env python
+# encoding: utf-8
+
+# License for Commercial Usage
+# Distributed under the "KODO EVALUATION LICENSE 1.3"
+# Licensees holding a valid commercial license may use this project in
+# accordance with the standard license agreement terms provided with the
+# Software (see accompanying file LICENSE.rst or
+# https://www.steinwurf.com/license), unless otherwise different terms and
+# conditions are agreed in writing between Licensee and Steinwurf ApS in which
+# case the license will be regulated by that separate written agreement.
+# License for Non-Commercial Usage
+# Distributed under the "KODO RESEARCH LICENSE 1.2"
+# Licensees holding a valid research license may use this project in accordance
+# with the license agreement terms provided with the Software
+# See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+"""
+Simulation comparing the fixed RateController with the
+AdaptiveRateController on a link where the loss alternates between 0.1% and
+15%.
+
+For each controller the number of packets sent per source symbol and the
+fraction of source symbols the decoder recovered are printed.
+"""
+
+import os
+import sys
+import random
+
+import kodo
+
+
+class FixedController:
+    """Adapts RateController to the interface of AdaptiveRateController"""
+
+    def __init__(self, n, k, window_symbols):
+        self.rate = kodo.slide.RateController(n=n, k=k)
+        self.window_symbols = window_symbols
+
+    def send_repair(self):
+        return self.rate.send_repair()
+
+    def advance(self):
+        self.rate.advance()
+
+    def feedback(self, decoded_upper_bound, loss, rank_gap):
+        pass
+
+
+def loss_probability(packet, phase_packets):
+    # Alternate between a good and a bad link
+    if (packet // phase_packets) % 2 == 0:
+        return 0.001
+    return 0.15
+
+
+def simulate(rate, packets, phase_packets, feedback_interval):
+
+    symbol_bytes = 16
+    decoder_capacity = 64
+
+    field = kodo.FiniteField.binary8
+
+    encoder = kodo.slide.Encoder(field)
+    encoder.configure(symbol_bytes)
+
+    decoder = kodo.slide.Decoder(field)
+    decoder.configure(symbol_bytes, capacity=decoder_capacity)
+
+    generator = kodo.slide.generator.RandomUniform(field)
+
+    decoded = set()
+    decoder.on_symbol_decoded(lambda index: decoded.add(index))
+
+    # The same loss pattern for every controller
+    channel = random.Random(1)
+
+    decoded_upper_bound = 0
+    sent = 0
+    lost = 0
+
+    for packet in range(packets):
+        if rate.send_repair() and encoder.stream_symbols > 0:
+            window = encoder.stream_range
+            seed = packet
+            generator.set_seed(seed)
+            coefficients = generator.generate(window)
+            symbol = encoder.encode_symbol(window, coefficients)
+            repair = True
+        else:
+            while encoder.stream_symbols >= rate.window_symbols:
+                encoder.pop_symbol()
+            encoder.push_symbol(os.urandom(symbol_bytes))
+            index = encoder.stream_upper_bound - 1
+            symbol = encoder.encode_systematic_symbol(index)
+            repair = False
+
+        rate.advance()
+
+        if channel.random() < loss_probability(packet, phase_packets):
+            lost += 1
+        else:
+            decoder.advance_to(encoder.stream_upper_bound)
+            if repair:
+                generator.set_seed(seed)
+                coefficients = generator.generate(window)
+                decoder.decode_symbol(symbol, window, coefficients)
+            else:
+                decoder.decode_systematic_symbol(symbol, index)
+
+        sent += 1
+
+        if sent == feedback_interval:
+            # Symbols which left the decoder's stream are given up on
+            decoded_upper_bound = max(
+                decoded_upper_bound, decoder.stream_lower_bound
+            )
+            while decoded_upper_bound in decoded:
+                decoded_upper_bound += 1
+
+            rate.feedback(
+                decoded_upper_bound, lost / sent, decoder.symbols_missing
+            )
+            sent = 0
+            lost = 0
+
+    sources = encoder.stream_upper_bound
+    return packets / sources, len(decoded) / sources
+
+
+def main():
+
+    packets = 40000
+    if "--dry-run" in sys.argv:
+        packets = 2000
+
+    phase_packets = packets // 8
+    feedback_interval = 20
+
+    controllers = [
+        ("fixed n=20 k=19", FixedController(n=20, k=19, window_symbols=32)),
+        ("fixed n=5 k=4", FixedController(n=5, k=4, window_symbols=32)),
+        ("adaptive", kodo.slide.AdaptiveRateController(max_window=32)),
+    ]
+
+    print(f"{'controller':<18}{'packets/source':>16}{'recovered':>12}")
+    for name, rate in controllers:
+        overhead, recovered = simulate(
+            rate, packets, phase_packets, feedback_interval
+        )
+        print(f"{name:<18}{overhead:>16.3f}{recovered:>12.2%}")
+
+
+if __name__ == "__main__":
+    main()
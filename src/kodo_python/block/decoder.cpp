@@ -19,7 +19,12 @@
 // See accompanying file LICENSE.rst or https://www.steinwurf.com/license
 
 #include "decoder.hpp"
+#include "generator/random_uniform.hpp"
+#include "generator/tunable.hpp"
 
+#include "../buffer.hpp"
+#include "../coefficients_bytes.hpp"
+#include "../memory_view.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
@@ -46,6 +51,7 @@ void block_decoder_enable_log(
     decoder.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             decoder_type* decoder = static_cast<decoder_type*>(data);
             assert(decoder->m_log_callback);
             decoder->m_log_callback(name, message);
@@ -54,43 +60,192 @@ void block_decoder_enable_log(
 }
 
 void block_decoder_decode_symbol(decoder_type& decoder,
-                                 pybind11::bytearray symbol,
-                                 pybind11::bytearray coefficients)
+                                 pybind11::buffer symbol,
+                                 pybind11::buffer coefficients)
 {
+    buffer_view symbol_view(symbol, true, "symbol");
+    buffer_view coefficients_view(coefficients, true, "coefficients");
 
-    if (symbol.size() < decoder.symbol_bytes())
+    if (symbol_view.size() < decoder.symbol_bytes())
     {
         throw pybind11::value_error(
             "symbol: not large enough to contain symbol");
     }
 
-    decoder.decode_symbol((uint8_t*)PyByteArray_AsString(symbol.ptr()),
-                          (uint8_t*)PyByteArray_AsString(coefficients.ptr()));
+    pybind11::gil_scoped_release release;
+    decoder.decode_symbol(symbol_view.data(), coefficients_view.data());
+}
+
+template <class Generate>
+void block_decoder_decode_symbol_with_seed(decoder_type& decoder,
+                                           kodo::finite_field field,
+                                           std::size_t symbols,
+                                           std::size_t coefficients_bytes,
+                                           pybind11::buffer symbol,
+                                           Generate generate)
+{
+    if (field != decoder.field())
+    {
+        throw pybind11::value_error(
+            "generator: must use the same field as the decoder");
+    }
+    if (symbols != decoder.symbols())
+    {
+        throw pybind11::value_error(
+            "generator: must be configured with Decoder.symbols");
+    }
+
+    buffer_view symbol_view(symbol, true, "symbol");
+
+    if (symbol_view.size() < decoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    decoder.m_coefficients.resize(coefficients_bytes);
+
+    pybind11::gil_scoped_release release;
+    generate(decoder.m_coefficients.data());
+    decoder.decode_symbol(symbol_view.data(), decoder.m_coefficients.data());
+}
+
+void block_decoder_decode_symbol_with_seed_random_uniform(
+    decoder_type& decoder, generator::random_uniform_type& generator,
+    uint64_t seed, pybind11::buffer symbol)
+{
+    block_decoder_decode_symbol_with_seed(
+        decoder, generator.field(), generator.symbols(),
+        generator.max_coefficients_bytes(), symbol,
+        [&generator, seed](uint8_t* data)
+        {
+            generator.set_seed(seed);
+            generator.generate(data);
+        });
+}
+
+void block_decoder_decode_symbol_with_seed_tunable(
+    decoder_type& decoder, generator::tunable_type& generator, uint64_t seed,
+    float density, pybind11::buffer symbol)
+{
+    block_decoder_decode_symbol_with_seed(
+        decoder, generator.field(), generator.symbols(),
+        generator.max_coefficients_bytes(), symbol,
+        [&generator, seed, density](uint8_t* data)
+        {
+            generator.set_seed(seed);
+            generator.generate(data, density);
+        });
+}
+
+auto block_decoder_decode_symbols(decoder_type& decoder,
+                                  pybind11::buffer symbols,
+                                  pybind11::buffer coefficients,
+                                  std::size_t count) -> std::size_t
+{
+    buffer_view symbols_view(symbols, true, "symbols");
+    buffer_view coefficients_view(coefficients, true, "coefficients");
+
+    auto symbol_bytes = decoder.symbol_bytes();
+    auto coefficient_bytes =
+        coefficients_bytes(decoder.field(), decoder.symbols());
+
+    auto symbol_stride = symbols_view.row_stride(symbol_bytes);
+    auto coefficients_stride = coefficients_view.row_stride(coefficient_bytes);
+
+    if (symbol_stride < symbol_bytes)
+    {
+        throw pybind11::value_error(
+            "symbols: rows not large enough to contain a symbol");
+    }
+    if (coefficients_stride < coefficient_bytes)
+    {
+        throw pybind11::value_error(
+            "coefficients: rows not large enough to contain the coefficients");
+    }
+    if (count > 0 &&
+        symbols_view.size() < (count - 1) * symbol_stride + symbol_bytes)
+    {
+        throw pybind11::value_error(
+            "symbols: not large enough to contain count symbols");
+    }
+    if (count > 0 && coefficients_view.size() <
+                         (count - 1) * coefficients_stride + coefficient_bytes)
+    {
+        throw pybind11::value_error(
+            "coefficients: not large enough to contain count coefficients");
+    }
+
+    pybind11::gil_scoped_release release;
+
+    std::size_t innovative = 0;
+    for (std::size_t i = 0; i < count && !decoder.is_complete(); ++i)
+    {
+        auto rank = decoder.rank();
+        decoder.decode_symbol(symbols_view.data() + i * symbol_stride,
+                              coefficients_view.data() +
+                                  i * coefficients_stride);
+        if (decoder.rank() > rank)
+        {
+            ++innovative;
+        }
+    }
+    return innovative;
 }
 
 void block_decoder_decode_systematic_symbol(decoder_type& decoder,
-                                            pybind11::bytearray symbol,
+                                            pybind11::buffer symbol,
                                             std::size_t index)
 {
-
     if (index >= decoder.symbols())
     {
         throw pybind11::value_error("index: must be less than symbols");
     }
 
-    decoder.decode_systematic_symbol(
-        (const uint8_t*)PyByteArray_AsString(symbol.ptr()), index);
+    buffer_view symbol_view(symbol, false, "symbol");
+
+    if (symbol_view.size() < decoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    pybind11::gil_scoped_release release;
+    decoder.decode_systematic_symbol(symbol_view.data(), index);
+}
+
+void block_decoder_configure(decoder_type& decoder, std::size_t symbols,
+                             std::size_t symbol_bytes)
+{
+    decoder.configure(symbols, symbol_bytes);
+    decoder.release_storage();
+}
+
+void block_decoder_reset(decoder_type& decoder)
+{
+    decoder.reset();
+    decoder.release_storage();
 }
 
 void block_decoder_set_symbols_storage(decoder_type& decoder,
-                                       pybind11::bytearray symbols_storage)
+                                       pybind11::buffer symbols_storage)
 {
-    decoder.set_symbols_storage(
-        (uint8_t*)PyByteArray_AsString(symbols_storage.ptr()));
+    buffer_view storage(symbols_storage, true, "symbols_storage");
+
+    if (storage.size() < decoder.block_bytes())
+    {
+        throw pybind11::value_error(
+            "symbols_storage: not large enough to contain block_bytes");
+    }
+
+    decoder.set_symbols_storage(storage.data());
+    decoder.release_storage();
+    decoder.m_symbols_storage =
+        std::make_shared<buffer_view>(std::move(storage));
 }
 
 void block_decoder_set_symbol_storage(decoder_type& decoder,
-                                      pybind11::bytearray symbol_storage,
+                                      pybind11::buffer symbol_storage,
                                       std::size_t index)
 {
     if (index >= decoder.symbols())
@@ -98,25 +253,38 @@ void block_decoder_set_symbol_storage(decoder_type& decoder,
         throw pybind11::value_error("index: must be less than symbols");
     }
 
-    decoder.set_symbol_storage(
-        (uint8_t*)PyByteArray_AsString(symbol_storage.ptr()), index);
+    buffer_view storage(symbol_storage, true, "symbol_storage");
+
+    if (storage.size() < decoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol_storage: not large enough to contain symbol_bytes");
+    }
+
+    decoder.set_symbol_storage(storage.data(), index);
+    decoder.m_symbol_storage[index] =
+        std::make_shared<buffer_view>(std::move(storage));
 }
 
 void block_decoder_recode_symbol(decoder_type& decoder,
-                                 pybind11::bytearray symbol,
-                                 pybind11::bytearray coefficients,
-                                 pybind11::bytearray coefficients_in)
+                                 pybind11::buffer symbol,
+                                 pybind11::buffer coefficients,
+                                 pybind11::buffer coefficients_in)
 {
-    if (symbol.size() < decoder.symbol_bytes())
+    buffer_view symbol_view(symbol, true, "symbol");
+    buffer_view coefficients_view(coefficients, true, "coefficients");
+    buffer_view coefficients_in_view(coefficients_in, false,
+                                     "coefficients_in");
+
+    if (symbol_view.size() < decoder.symbol_bytes())
     {
         throw pybind11::value_error(
             "symbol: not large enough to contain symbol");
     }
 
-    decoder.recode_symbol(
-        (uint8_t*)PyByteArray_AsString(symbol.ptr()),
-        (uint8_t*)PyByteArray_AsString(coefficients.ptr()),
-        (const uint8_t*)PyByteArray_AsString(coefficients_in.ptr()));
+    pybind11::gil_scoped_release release;
+    decoder.recode_symbol(symbol_view.data(), coefficients_view.data(),
+                          coefficients_in_view.data());
 }
 
 auto block_decoder_symbol_data(decoder_type& decoder, std::size_t index)
@@ -130,6 +298,44 @@ auto block_decoder_symbol_data(decoder_type& decoder, std::size_t index)
     return pybind11::bytearray{(char*)symbol, decoder.symbol_bytes()};
 }
 
+auto block_decoder_symbol_view(decoder_type& decoder, std::size_t index)
+    -> pybind11::memoryview
+{
+    if (index >= decoder.symbols())
+    {
+        throw pybind11::value_error("index: must be less than symbols");
+    }
+    auto symbol = decoder.symbol_data(index);
+    if (symbol == nullptr)
+    {
+        throw pybind11::value_error("index: symbol storage not set");
+    }
+    return make_memoryview(pybind11::cast(&decoder), symbol,
+                           decoder.symbol_bytes(),
+                           decoder.storage_export(index));
+}
+
+auto block_decoder_symbols_view(decoder_type& decoder)
+    -> pybind11::memoryview
+{
+    const uint8_t* data = decoder.symbol_data(0);
+    if (data == nullptr)
+    {
+        throw pybind11::value_error("symbols storage not set");
+    }
+    for (std::size_t index = 1; index < decoder.symbols(); ++index)
+    {
+        if (decoder.symbol_data(index) != data + index * decoder.symbol_bytes())
+        {
+            throw pybind11::value_error(
+                "symbols storage is not contiguous, use symbol_view");
+        }
+    }
+    return make_memoryview(pybind11::cast(&decoder), data,
+                           decoder.block_bytes(),
+                           decoder.storage_exports());
+}
+
 void decoder(pybind11::module& m)
 {
     using namespace pybind11;
@@ -137,7 +343,7 @@ void decoder(pybind11::module& m)
         .def(init<kodo::finite_field>(), arg("field"),
              "The block decoder constructor\n\n"
              "\t:param field: the chosen finite field.\n")
-        .def("configure", &decoder_type::configure, arg("symbols"),
+        .def("configure", &block_decoder_configure, arg("symbols"),
              arg("symbol_bytes"),
              "Configure the decoder with the given parameters. This is also "
              "useful for reusing an existing coder. Note that the "
@@ -145,7 +351,9 @@ void decoder(pybind11::module& m)
              "in a clean state after this operation.\n\n"
              "\t:param symbols: The number of symbols.\n"
              "\t:param symbol_bytes: The size of a symbol in bytes.\n")
-        .def("reset", &decoder_type::reset, "Reset the state of the decoder.\n")
+        .def("reset", &block_decoder_reset,
+             "Reset the state of the decoder. The symbol storage is released "
+             "and must be set again.\n")
         .def_property_readonly(
             "symbols", &decoder_type::symbols,
             "Return the number of symbols supported by this decoder.\n")
@@ -156,9 +364,11 @@ void decoder(pybind11::module& m)
                                "Return the :class:`~kodo.FiniteField` used.\n")
         .def("set_symbols_storage", &block_decoder_set_symbols_storage,
              arg("symbols_storage"),
-             "Initialize all the symbols in the block.\n\n"
-             "\tparam symbols_storage: The buffer containing all the data for "
-             "the the block.")
+             "Initialize all the symbols in the block. The buffer is kept "
+             "exported, i.e. it cannot be resized, until the decoder is "
+             "reconfigured or destroyed.\n\n"
+             "\tparam symbols_storage: The writable buffer e.g. a bytearray, "
+             "mmap or numpy array where the block will be decoded.")
         .def("set_symbol_storage", &block_decoder_set_symbol_storage,
              arg("symbol_storage"), arg("index"),
              "Set a symbol to be encoded.\n\n"
@@ -169,6 +379,17 @@ void decoder(pybind11::module& m)
         .def("symbol_data", &block_decoder_symbol_data, arg("index"),
              "Get the memory for a symbol.\n\n"
              "\t:param index: The index of the symbol to get.\n")
+        .def("symbol_view", &block_decoder_symbol_view, arg("index"),
+             "Return a read-only memoryview of a symbol in the symbols "
+             "storage. Unlike symbol_data no copy is made, the view reflects "
+             "the storage as decoding progresses. The decoder and the "
+             "storage are kept alive and exported while the view exists, "
+             "also after the decoder is reset or reconfigured.\n\n"
+             "\t:param index: The index of the symbol.\n")
+        .def("symbols_view", &block_decoder_symbols_view,
+             "Return a read-only memoryview of the whole block. This requires "
+             "the storage to be contiguous, e.g. set with "
+             "set_symbols_storage.\n")
         .def_property_readonly("block_bytes", &decoder_type::block_bytes,
                                "Return the total number of bytes that can be "
                                "encoded with this decoder.\n")
@@ -179,6 +400,37 @@ void decoder(pybind11::module& m)
              "symbol_bytes() bytes in size.\n"
              "\t:param coefficients: The coding coefficients that describe the "
              "encoding performed on the symbol.\n")
+        .def("decode_symbol_with_seed",
+             &block_decoder_decode_symbol_with_seed_random_uniform,
+             arg("generator"), arg("seed"), arg("symbol"),
+             "Seed the generator, generate the coefficients and decode a "
+             "symbol in a single call. This is the counterpart of "
+             "Encoder.encode_symbol_with_seed().\n\n"
+             "\t:param generator: A RandomUniform or Tunable generator "
+             "using the decoder's field and configured with Decoder.symbols.\n"
+             "\t:param seed: The seed used when encoding the symbol.\n"
+             "\t:param density: Only for the Tunable generator, the density "
+             "used when encoding the symbol.\n"
+             "\t:param symbol: The writable buffer containing the symbol, it "
+             "is modified by the decoder.\n")
+        .def("decode_symbol_with_seed",
+             &block_decoder_decode_symbol_with_seed_tunable, arg("generator"),
+             arg("seed"), arg("density"), arg("symbol"))
+        .def("decode_symbols", &block_decoder_decode_symbols, arg("symbols"),
+             arg("coefficients"), arg("count"),
+             "Feed a batch of coded symbols to the decoder in a single call. "
+             "Decoding stops early once the decoder is complete. Like "
+             "Decoder.decode_symbol() the buffers are modified in place.\n\n"
+             "\t:param symbols: A writable buffer with one symbol per row. "
+             "For two dimensional buffers e.g. numpy arrays a row is the "
+             "first dimension, otherwise rows are Decoder.symbol_bytes "
+             "apart.\n"
+             "\t:param coefficients: A writable buffer with the coding "
+             "coefficients of one symbol per row. For two dimensional buffers "
+             "a row is the first dimension, otherwise rows are packed "
+             "back to back.\n"
+             "\t:param count: The number of symbols in the batch.\n"
+             "\t:return: The number of symbols which increased the rank.\n")
         .def("decode_systematic_symbol",
              &block_decoder_decode_systematic_symbol, arg("symbol"),
              arg("index"),
@@ -20,12 +20,19 @@
 
 #pragma once
 
+#include "../buffer.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
 
 #include <kodo/block/decoder.hpp>
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace kodo_python
 {
 inline namespace STEINWURF_KODO_PYTHON_VERSION
@@ -40,6 +47,45 @@ struct decoder_wrapper : kodo::block::decoder
     {
     }
     std::function<void(const std::string&, const std::string&)> m_log_callback;
+
+    /// Buffer export pinning the memory given with set_symbols_storage,
+    /// shared with the memoryviews of the storage
+    std::shared_ptr<buffer_view> m_symbols_storage;
+
+    /// Buffer exports pinning the memory given with set_symbol_storage, one
+    /// per symbol index
+    std::vector<std::shared_ptr<buffer_view>> m_symbol_storage;
+
+    /// Release the buffer exports of the symbol storage
+    void release_storage()
+    {
+        m_symbols_storage.reset();
+        m_symbol_storage.clear();
+        m_symbol_storage.resize(symbols());
+    }
+
+    /// @return The export of the storage holding the symbol
+    auto storage_export(std::size_t index) const -> std::shared_ptr<void>
+    {
+        if (m_symbol_storage[index])
+        {
+            return m_symbol_storage[index];
+        }
+        return m_symbols_storage;
+    }
+
+    /// @return The exports of all the storage
+    auto storage_exports() const -> std::shared_ptr<void>
+    {
+        auto exports =
+            std::make_shared<std::vector<std::shared_ptr<buffer_view>>>(
+                m_symbol_storage);
+        exports->push_back(m_symbols_storage);
+        return exports;
+    }
+
+    /// Scratch memory for the coefficients of decode_symbol_with_seed
+    std::vector<uint8_t> m_coefficients;
 };
 
 using decoder_type = decoder_wrapper;
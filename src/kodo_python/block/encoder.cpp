@@ -19,7 +19,12 @@
 // See accompanying file LICENSE.rst or https://www.steinwurf.com/license
 
 #include "encoder.hpp"
+#include "generator/random_uniform.hpp"
+#include "generator/rs_cauchy.hpp"
+#include "generator/tunable.hpp"
 
+#include "../buffer.hpp"
+#include "../coefficients_bytes.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
@@ -37,17 +42,6 @@ inline namespace STEINWURF_KODO_PYTHON_VERSION
 {
 namespace block
 {
-
-struct encoder_wrapper : kodo::block::encoder
-{
-    encoder_wrapper(kodo::finite_field field) : kodo::block::encoder(field)
-    {
-    }
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using encoder_type = encoder_wrapper;
-
 void block_encoder_enable_log(
     encoder_type& encoder,
     std::function<void(const std::string&, const std::string&)> callback)
@@ -56,6 +50,7 @@ void block_encoder_enable_log(
     encoder.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             encoder_type* encoder = static_cast<encoder_type*>(data);
             assert(encoder->m_log_callback);
             encoder->m_log_callback(name, message);
@@ -64,14 +59,16 @@ void block_encoder_enable_log(
 }
 
 auto block_encoder_encode_symbol(encoder_type& encoder,
-                                 pybind11::bytearray coefficients)
+                                 pybind11::buffer coefficients)
     -> pybind11::bytearray
 {
+    buffer_view coefficients_view(coefficients, false, "coefficients");
 
     std::vector<uint8_t> symbol(encoder.symbol_bytes());
-
-    encoder.encode_symbol(symbol.data(),
-                          (uint8_t*)PyByteArray_AsString(coefficients.ptr()));
+    {
+        pybind11::gil_scoped_release release;
+        encoder.encode_symbol(symbol.data(), coefficients_view.data());
+    }
     return pybind11::bytearray{(char*)symbol.data(), symbol.size()};
 }
 
@@ -85,13 +82,241 @@ auto block_encoder_encode_systematic_symbol(encoder_type& encoder,
     }
 
     std::vector<uint8_t> symbol(encoder.symbol_bytes());
-
-    encoder.encode_systematic_symbol(symbol.data(), index);
+    {
+        pybind11::gil_scoped_release release;
+        encoder.encode_systematic_symbol(symbol.data(), index);
+    }
     return pybind11::bytearray{(char*)symbol.data(), symbol.size()};
 }
 
+void block_encoder_encode_symbol_into(encoder_type& encoder,
+                                      pybind11::buffer symbol,
+                                      pybind11::buffer coefficients)
+{
+    buffer_view symbol_view(symbol, true, "symbol");
+    buffer_view coefficients_view(coefficients, false, "coefficients");
+
+    if (symbol_view.size() < encoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    pybind11::gil_scoped_release release;
+    encoder.encode_symbol(symbol_view.data(), coefficients_view.data());
+}
+
+void block_encoder_encode_systematic_symbol_into(encoder_type& encoder,
+                                                 pybind11::buffer symbol,
+                                                 std::size_t index)
+{
+    if (index >= encoder.symbols())
+    {
+        throw pybind11::value_error("index: must be less than symbols");
+    }
+
+    buffer_view symbol_view(symbol, true, "symbol");
+
+    if (symbol_view.size() < encoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    pybind11::gil_scoped_release release;
+    encoder.encode_systematic_symbol(symbol_view.data(), index);
+}
+
+template <class Generate>
+auto block_encoder_encode_symbols(encoder_type& encoder,
+                                  kodo::finite_field field, std::size_t symbols,
+                                  std::size_t count,
+                                  pybind11::object symbols_out,
+                                  pybind11::object coefficients_out,
+                                  Generate generate) -> pybind11::tuple
+{
+    if (field != encoder.field())
+    {
+        throw pybind11::value_error(
+            "generator: must use the same field as the encoder");
+    }
+    if (symbols != encoder.symbols())
+    {
+        throw pybind11::value_error(
+            "generator: must be configured with Encoder.symbols");
+    }
+
+    auto symbol_bytes = encoder.symbol_bytes();
+    auto coefficient_bytes =
+        coefficients_bytes(encoder.field(), encoder.symbols());
+
+    if (symbols_out.is_none())
+    {
+        symbols_out = make_bytearray(count * symbol_bytes);
+    }
+    if (coefficients_out.is_none())
+    {
+        coefficients_out = make_bytearray(count * coefficient_bytes);
+    }
+
+    buffer_view symbols_view(symbols_out, true, "symbols");
+    buffer_view coefficients_view(coefficients_out, true, "coefficients");
+
+    if (symbols_view.size() < count * symbol_bytes)
+    {
+        throw pybind11::value_error(
+            "symbols: not large enough to contain count symbols");
+    }
+    if (coefficients_view.size() < count * coefficient_bytes)
+    {
+        throw pybind11::value_error(
+            "coefficients: not large enough to contain count coefficients");
+    }
+
+    {
+        pybind11::gil_scoped_release release;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            uint8_t* coefficients =
+                coefficients_view.data() + i * coefficient_bytes;
+
+            generate(coefficients);
+            encoder.encode_symbol(symbols_view.data() + i * symbol_bytes,
+                                  coefficients);
+        }
+    }
+
+    return pybind11::make_tuple(symbols_out, coefficients_out);
+}
+
+auto block_encoder_encode_symbols_random_uniform(
+    encoder_type& encoder, generator::random_uniform_type& generator,
+    std::size_t count, pybind11::object symbols,
+    pybind11::object coefficients) -> pybind11::tuple
+{
+    return block_encoder_encode_symbols(
+        encoder, generator.field(), generator.symbols(), count, symbols,
+        coefficients,
+        [&generator](uint8_t* data) { generator.generate(data); });
+}
+
+auto block_encoder_encode_symbols_tunable(
+    encoder_type& encoder, generator::tunable_type& generator,
+    std::size_t count, float density, pybind11::object symbols,
+    pybind11::object coefficients) -> pybind11::tuple
+{
+    return block_encoder_encode_symbols(
+        encoder, generator.field(), generator.symbols(), count, symbols,
+        coefficients,
+        [&generator, density](uint8_t* data)
+        { generator.generate(data, density); });
+}
+
+auto block_encoder_encode_symbols_rs_cauchy(
+    encoder_type& encoder, generator::rs_cauchy_type& generator,
+    std::size_t count, pybind11::object symbols,
+    pybind11::object coefficients) -> pybind11::tuple
+{
+    if (count > generator.remaining_repair_symbols())
+    {
+        throw pybind11::value_error(
+            "count: must be less than or equal to "
+            "RSCauchy.remaining_repair_symbols");
+    }
+
+    return block_encoder_encode_symbols(
+        encoder, generator.field(), generator.symbols(), count, symbols,
+        coefficients,
+        [&generator](uint8_t* data) { generator.generate(data); });
+}
+
+template <class Generate>
+auto block_encoder_encode_symbol_with_seed(encoder_type& encoder,
+                                           kodo::finite_field field,
+                                           std::size_t symbols,
+                                           std::size_t coefficients_bytes,
+                                           pybind11::object symbol,
+                                           Generate generate)
+    -> pybind11::object
+{
+    if (field != encoder.field())
+    {
+        throw pybind11::value_error(
+            "generator: must use the same field as the encoder");
+    }
+    if (symbols != encoder.symbols())
+    {
+        throw pybind11::value_error(
+            "generator: must be configured with Encoder.symbols");
+    }
+
+    if (symbol.is_none())
+    {
+        symbol = make_bytearray(encoder.symbol_bytes());
+    }
+
+    buffer_view symbol_view(symbol, true, "symbol");
+
+    if (symbol_view.size() < encoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    encoder.m_coefficients.resize(coefficients_bytes);
+    {
+        pybind11::gil_scoped_release release;
+        generate(encoder.m_coefficients.data());
+        encoder.encode_symbol(symbol_view.data(),
+                              encoder.m_coefficients.data());
+    }
+    return symbol;
+}
+
+auto block_encoder_encode_symbol_with_seed_random_uniform(
+    encoder_type& encoder, generator::random_uniform_type& generator,
+    uint64_t seed, pybind11::object symbol) -> pybind11::object
+{
+    return block_encoder_encode_symbol_with_seed(
+        encoder, generator.field(), generator.symbols(),
+        generator.max_coefficients_bytes(), symbol,
+        [&generator, seed](uint8_t* data)
+        {
+            generator.set_seed(seed);
+            generator.generate(data);
+        });
+}
+
+auto block_encoder_encode_symbol_with_seed_tunable(
+    encoder_type& encoder, generator::tunable_type& generator, uint64_t seed,
+    float density, pybind11::object symbol) -> pybind11::object
+{
+    return block_encoder_encode_symbol_with_seed(
+        encoder, generator.field(), generator.symbols(),
+        generator.max_coefficients_bytes(), symbol,
+        [&generator, seed, density](uint8_t* data)
+        {
+            generator.set_seed(seed);
+            generator.generate(data, density);
+        });
+}
+
+void block_encoder_configure(encoder_type& encoder, std::size_t symbols,
+                             std::size_t symbol_bytes)
+{
+    encoder.configure(symbols, symbol_bytes);
+    encoder.release_storage();
+}
+
+void block_encoder_reset(encoder_type& encoder)
+{
+    encoder.reset();
+    encoder.release_storage();
+}
+
 void block_encoder_set_symbols_storage(encoder_type& encoder,
-                                       pybind11::bytearray symbols_storage)
+                                       pybind11::buffer symbols_storage)
 {
 
     if (encoder.rank() != 0)
@@ -99,12 +324,21 @@ void block_encoder_set_symbols_storage(encoder_type& encoder,
         throw std::runtime_error("symbol storage must only be set once");
     }
 
-    encoder.set_symbols_storage(
-        (uint8_t*)PyByteArray_AsString(symbols_storage.ptr()));
+    buffer_view storage(symbols_storage, false, "symbols_storage");
+
+    if (storage.size() < encoder.block_bytes())
+    {
+        throw pybind11::value_error(
+            "symbols_storage: not large enough to contain block_bytes");
+    }
+
+    encoder.set_symbols_storage(storage.data());
+    encoder.release_storage();
+    encoder.m_symbols_storage = std::move(storage);
 }
 
 void block_encoder_set_symbol_storage(encoder_type& encoder,
-                                      pybind11::bytearray symbol_storage,
+                                      pybind11::buffer symbol_storage,
                                       std::size_t index)
 {
     if (index >= encoder.symbols())
@@ -117,8 +351,16 @@ void block_encoder_set_symbol_storage(encoder_type& encoder,
         throw pybind11::value_error("index: symbols is already set");
     }
 
-    encoder.set_symbol_storage(
-        (uint8_t*)PyByteArray_AsString(symbol_storage.ptr()), index);
+    buffer_view storage(symbol_storage, false, "symbol_storage");
+
+    if (storage.size() < encoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol_storage: not large enough to contain symbol_bytes");
+    }
+
+    encoder.set_symbol_storage(storage.data(), index);
+    encoder.m_symbol_storage[index] = std::move(storage);
 }
 
 void encoder(pybind11::module& m)
@@ -128,7 +370,7 @@ void encoder(pybind11::module& m)
         .def(init<kodo::finite_field>(), arg("field"),
              "The block encoder constructor\n\n"
              "\t:param field: the chosen finite field.\n")
-        .def("configure", &encoder_type::configure, arg("symbols"),
+        .def("configure", &block_encoder_configure, arg("symbols"),
              arg("symbol_bytes"),
              "Configure the encoder with the given parameters. This is also "
              "useful for reusing an existing coder. Note that the "
@@ -136,7 +378,9 @@ void encoder(pybind11::module& m)
              "in a clean state after this operation.\n\n"
              "\t:param symbols: The number of symbols.\n"
              "\t:param symbol_bytes: The size of a symbol in bytes.")
-        .def("reset", &encoder_type::reset, "Reset the state of the encoder.\n")
+        .def("reset", &block_encoder_reset,
+             "Reset the state of the encoder. The symbol storage is released "
+             "and must be set again.\n")
         .def_property_readonly(
             "symbols", &encoder_type::symbols,
             "Return the number of symbols supported by this encoder.\n")
@@ -152,9 +396,12 @@ void encoder(pybind11::module& m)
                                "Return the rank of the encoder.\n")
         .def("set_symbols_storage", &block_encoder_set_symbols_storage,
              arg("symbols_storage"),
-             "Set the symbols to be encoded.\n\n"
+             "Set the symbols to be encoded. The buffer is kept exported, i.e. "
+             "it cannot be resized, until the encoder is reconfigured or "
+             "destroyed.\n\n"
              "\t:param symbols_storage: The buffer containing all the data for "
-             "the block.\n")
+             "the block. Any object supporting the buffer protocol can be "
+             "used e.g. bytes, bytearray, mmap or a numpy array.\n")
         .def("set_symbol_storage", &block_encoder_set_symbol_storage,
              arg("symbol_storage"), arg("index"),
              "Set a symbol to be encoded.\n\n"
@@ -173,6 +420,68 @@ void encoder(pybind11::module& m)
              "Creates a new systematic, i.e, un-coded symbol given the passed "
              "index.\n\n"
              "\t:param index: The index of the systematic symbol to produce.")
+        .def("encode_symbol_into", &block_encoder_encode_symbol_into,
+             arg("symbol"), arg("coefficients"),
+             "Write a new encoded symbol given the passed encoding "
+             "coefficients into the given buffer. Unlike "
+             "Encoder.encode_symbol() no memory is allocated.\n\n"
+             "\t:param symbol: A writable buffer e.g. a bytearray, memoryview "
+             "or numpy array of at least Encoder.symbol_bytes bytes.\n"
+             "\t:param coefficients: The coding coefficients.\n")
+        .def("encode_systematic_symbol_into",
+             &block_encoder_encode_systematic_symbol_into, arg("symbol"),
+             arg("index"),
+             "Write a systematic, i.e, un-coded symbol given the passed index "
+             "into the given buffer. Unlike Encoder.encode_systematic_symbol() "
+             "no memory is allocated.\n\n"
+             "\t:param symbol: A writable buffer e.g. a bytearray, memoryview "
+             "or numpy array of at least Encoder.symbol_bytes bytes.\n"
+             "\t:param index: The index of the systematic symbol to produce.")
+        .def("encode_symbols", &block_encoder_encode_symbols_random_uniform,
+             arg("generator"), arg("count"), arg("symbols") = none(),
+             arg("coefficients") = none(),
+             "Generate coefficients and encode count symbols in a single "
+             "call. Symbol i is written to symbols[i * symbol_bytes] and its "
+             "coefficients to coefficients[i * coefficients_bytes] where "
+             "coefficients_bytes is the coefficient size of the encoder's "
+             "field and symbols.\n\n"
+             "\t:param generator: A RandomUniform, Tunable or RSCauchy "
+             "generator using the encoder's field and configured with "
+             "Encoder.symbols.\n"
+             "\t:param count: The number of symbols to encode.\n"
+             "\t:param density: Only for the Tunable generator, the density "
+             "of the generated coefficients.\n"
+             "\t:param symbols: An optional writable buffer of at least count "
+             "* Encoder.symbol_bytes bytes. If None a bytearray is "
+             "allocated.\n"
+             "\t:param coefficients: An optional writable buffer for the "
+             "coefficients. If None a bytearray is allocated.\n"
+             "\t:return: A tuple containing the symbols and coefficients "
+             "buffers.\n")
+        .def("encode_symbols", &block_encoder_encode_symbols_tunable,
+             arg("generator"), arg("count"), arg("density"),
+             arg("symbols") = none(), arg("coefficients") = none())
+        .def("encode_symbols", &block_encoder_encode_symbols_rs_cauchy,
+             arg("generator"), arg("count"), arg("symbols") = none(),
+             arg("coefficients") = none())
+        .def("encode_symbol_with_seed",
+             &block_encoder_encode_symbol_with_seed_random_uniform,
+             arg("generator"), arg("seed"), arg("symbol") = none(),
+             "Seed the generator, generate the coefficients and encode a "
+             "symbol in a single call. The coefficients are kept internally, "
+             "a decoder regenerates them from the seed with "
+             "Decoder.decode_symbol_with_seed().\n\n"
+             "\t:param generator: A RandomUniform or Tunable generator "
+             "using the encoder's field and configured with Encoder.symbols.\n"
+             "\t:param seed: The seed used for the coefficients.\n"
+             "\t:param density: Only for the Tunable generator, the density "
+             "of the generated coefficients.\n"
+             "\t:param symbol: An optional writable buffer of at least "
+             "Encoder.symbol_bytes bytes. If None a bytearray is allocated.\n"
+             "\t:return: The buffer containing the encoded symbol.\n")
+        .def("encode_symbol_with_seed",
+             &block_encoder_encode_symbol_with_seed_tunable, arg("generator"),
+             arg("seed"), arg("density"), arg("symbol") = none())
         .def(
             "enable_log", &block_encoder_enable_log, arg("callback"),
             "Enable logging for this encoder.\n\n"
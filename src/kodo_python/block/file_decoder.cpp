@@ -0,0 +1,391 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "file_decoder.hpp"
+#include "file_packet.hpp"
+
+#include "../buffer.hpp"
+#include "../coefficients_bytes.hpp"
+#include "../mapped_file.hpp"
+#include "../thread_pool.hpp"
+#include "../version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <kodo/block/decoder.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace block
+{
+/// The coder state of a single generation of the file
+struct file_decoder_generation
+{
+    file_decoder_generation(kodo::finite_field field) : m_decoder(field)
+    {
+    }
+
+    kodo::block::decoder m_decoder;
+
+    /// Zero padded storage of the last generation if it is not full, copied
+    /// to the file once decoded
+    std::vector<uint8_t> m_padded;
+
+    std::atomic<bool> m_complete{false};
+};
+
+struct file_decoder_type
+{
+    file_decoder_type(const std::string& path, kodo::finite_field field,
+                      std::size_t symbols, std::size_t symbol_bytes,
+                      std::size_t file_bytes, std::size_t threads) :
+        m_file(path, file_bytes),
+        m_pool(threads), m_field(field), m_symbols(symbols),
+        m_symbol_bytes(symbol_bytes),
+        m_coefficients_bytes(coefficients_bytes(field, symbols))
+    {
+        if (symbols == 0)
+        {
+            throw pybind11::value_error("symbols: must be greater than zero");
+        }
+        if (symbol_bytes == 0)
+        {
+            throw pybind11::value_error(
+                "symbol_bytes: must be greater than zero");
+        }
+        if (file_bytes == 0)
+        {
+            throw pybind11::value_error(
+                "file_bytes: must be greater than zero");
+        }
+
+        std::size_t generation_bytes = symbols * symbol_bytes;
+        std::size_t generations =
+            (file_bytes + generation_bytes - 1) / generation_bytes;
+
+        if (generations > file_packet::coded_index)
+        {
+            throw pybind11::value_error(
+                "symbols: too many generations, increase symbols or "
+                "symbol_bytes");
+        }
+
+        m_generations.reserve(generations);
+        for (std::size_t i = 0; i < generations; ++i)
+        {
+            auto generation = std::make_unique<file_decoder_generation>(field);
+            generation->m_decoder.configure(symbols, symbol_bytes);
+
+            std::size_t offset = i * generation_bytes;
+
+            if (file_bytes - offset < generation_bytes)
+            {
+                generation->m_padded.resize(generation_bytes);
+                generation->m_decoder.set_symbols_storage(
+                    generation->m_padded.data());
+            }
+            else
+            {
+                // Decode straight into the file
+                generation->m_decoder.set_symbols_storage(m_file.data() +
+                                                          offset);
+            }
+            m_generations.push_back(std::move(generation));
+        }
+    }
+
+    auto packet_bytes() const -> std::size_t
+    {
+        return file_packet::packet_bytes(m_coefficients_bytes, m_symbol_bytes);
+    }
+
+    mapped_file m_file;
+    thread_pool m_pool;
+    kodo::finite_field m_field;
+    std::size_t m_symbols;
+    std::size_t m_symbol_bytes;
+    std::size_t m_coefficients_bytes;
+    std::atomic<std::size_t> m_completed{0};
+    std::vector<std::unique_ptr<file_decoder_generation>> m_generations;
+
+    /// Serializes decode_packets calls from different threads, as the
+    /// generation decoders are shared. It is only locked with the GIL
+    /// released.
+    std::mutex m_decode_mutex;
+};
+
+void block_file_decoder_decode_generation(
+    file_decoder_type& decoder, std::size_t generation_id,
+    const std::vector<const uint8_t*>& packets)
+{
+    auto& generation = *decoder.m_generations[generation_id];
+    auto packet_bytes = decoder.packet_bytes();
+
+    // The decoder modifies the symbol and coefficients in place, so the
+    // packets are copied as the packet buffer may be read-only
+    std::vector<uint8_t> scratch(packet_bytes);
+
+    for (const uint8_t* packet : packets)
+    {
+        if (generation.m_decoder.is_complete())
+        {
+            break;
+        }
+
+        std::memcpy(scratch.data(), packet, packet_bytes);
+        uint8_t* coefficients = file_packet::coefficients(scratch.data());
+        uint8_t* symbol =
+            file_packet::symbol(scratch.data(), decoder.m_coefficients_bytes);
+
+        auto index = file_packet::index(packet);
+        if (index == file_packet::coded_index)
+        {
+            generation.m_decoder.decode_symbol(symbol, coefficients);
+        }
+        else
+        {
+            generation.m_decoder.decode_systematic_symbol(symbol, index);
+        }
+    }
+
+    if (generation.m_decoder.is_complete() && !generation.m_padded.empty())
+    {
+        std::size_t offset =
+            generation_id * decoder.m_symbols * decoder.m_symbol_bytes;
+        std::memcpy(decoder.m_file.data() + offset, generation.m_padded.data(),
+                    decoder.m_file.size() - offset);
+    }
+}
+
+auto block_file_decoder_decode_packets(file_decoder_type& decoder,
+                                       pybind11::buffer packets)
+    -> pybind11::list
+{
+    buffer_view packets_view(packets, false, "packets");
+    auto packet_bytes = decoder.packet_bytes();
+
+    if (packets_view.size() % packet_bytes != 0)
+    {
+        throw pybind11::value_error(
+            "packets: size must be a multiple of FileDecoder.packet_bytes");
+    }
+
+    std::size_t count = packets_view.size() / packet_bytes;
+    std::vector<uint32_t> generation_ids;
+    std::vector<uint32_t> completed_ids;
+
+    // The packets of each generation, local to this call as the packets
+    // point into the caller's buffer
+    std::vector<std::vector<const uint8_t*>> shards(
+        decoder.m_generations.size());
+
+    // Validate all packets before decoding any of them
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const uint8_t* packet = packets_view.data() + i * packet_bytes;
+        auto id = file_packet::generation(packet);
+        auto index = file_packet::index(packet);
+
+        if (id >= decoder.m_generations.size())
+        {
+            throw pybind11::value_error(
+                "packets: generation must be less than "
+                "FileDecoder.generations");
+        }
+        if (index != file_packet::coded_index && index >= decoder.m_symbols)
+        {
+            throw pybind11::value_error(
+                "packets: index must be less than FileDecoder.symbols");
+        }
+    }
+
+    {
+        pybind11::gil_scoped_release release;
+        std::lock_guard<std::mutex> lock(decoder.m_decode_mutex);
+
+        // Shard the packets by generation, keeping their order
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const uint8_t* packet = packets_view.data() + i * packet_bytes;
+            auto id = file_packet::generation(packet);
+            auto& generation = *decoder.m_generations[id];
+
+            if (generation.m_complete)
+            {
+                continue;
+            }
+            if (shards[id].empty())
+            {
+                generation_ids.push_back(id);
+            }
+            shards[id].push_back(packet);
+        }
+
+        decoder.m_pool.parallel_for(
+            generation_ids.size(),
+            [&](std::size_t i)
+            {
+                auto id = generation_ids[i];
+                block_file_decoder_decode_generation(decoder, id, shards[id]);
+            });
+
+        // Mark the completed generations before the lock is released, so
+        // a concurrent call neither decodes nor reports them again
+        for (auto id : generation_ids)
+        {
+            auto& generation = *decoder.m_generations[id];
+            if (generation.m_decoder.is_complete())
+            {
+                generation.m_complete = true;
+                decoder.m_completed++;
+                completed_ids.push_back(id);
+            }
+        }
+    }
+
+    pybind11::list completed;
+    for (auto id : completed_ids)
+    {
+        completed.append(id);
+    }
+    return completed;
+}
+
+auto block_file_decoder_is_generation_complete(file_decoder_type& decoder,
+                                               std::size_t generation) -> bool
+{
+    if (generation >= decoder.m_generations.size())
+    {
+        throw pybind11::value_error(
+            "generation: must be less than FileDecoder.generations");
+    }
+    return decoder.m_generations[generation]->m_complete;
+}
+
+auto block_file_decoder_generation_rank(file_decoder_type& decoder,
+                                        std::size_t generation) -> std::size_t
+{
+    if (generation >= decoder.m_generations.size())
+    {
+        throw pybind11::value_error(
+            "generation: must be less than FileDecoder.generations");
+    }
+
+    pybind11::gil_scoped_release release;
+    std::lock_guard<std::mutex> lock(decoder.m_decode_mutex);
+    return decoder.m_generations[generation]->m_decoder.rank();
+}
+
+void block_file_decoder_flush(file_decoder_type& decoder)
+{
+    pybind11::gil_scoped_release release;
+    decoder.m_file.flush();
+}
+
+void file_decoder(pybind11::module& m)
+{
+    using namespace pybind11;
+    class_<file_decoder_type>(
+        m, "FileDecoder",
+        "Decodes the packets of a :class:`~kodo.block.FileEncoder` straight "
+        "into a file. The generations are decoded in parallel and written to "
+        "the memory mapped file as they are decoded.\n")
+        .def(init<const std::string&, kodo::finite_field, std::size_t,
+                  std::size_t, std::size_t, std::size_t>(),
+             arg("path"), arg("field"), arg("symbols"), arg("symbol_bytes"),
+             arg("file_bytes"), arg("threads") = 0,
+             "The file decoder constructor. The file is created, or "
+             "truncated, with a size of file_bytes.\n\n"
+             "\t:param path: The path of the file to decode into.\n"
+             "\t:param field: The finite field used by the encoder.\n"
+             "\t:param symbols: The number of symbols in a generation.\n"
+             "\t:param symbol_bytes: The size of a symbol in bytes.\n"
+             "\t:param file_bytes: The size of the file in bytes.\n"
+             "\t:param threads: The number of threads used for decoding, zero "
+             "selects the number of hardware threads.\n")
+        .def_property_readonly(
+            "field", [](const file_decoder_type& d) { return d.m_field; },
+            "Return the :class:`~kodo.FiniteField` used.\n")
+        .def_property_readonly(
+            "symbols", [](const file_decoder_type& d) { return d.m_symbols; },
+            "Return the number of symbols in a generation.\n")
+        .def_property_readonly(
+            "symbol_bytes",
+            [](const file_decoder_type& d) { return d.m_symbol_bytes; },
+            "Return the size of a symbol in bytes.\n")
+        .def_property_readonly(
+            "file_bytes",
+            [](const file_decoder_type& d) { return d.m_file.size(); },
+            "Return the size of the file in bytes.\n")
+        .def_property_readonly(
+            "generations",
+            [](const file_decoder_type& d) { return d.m_generations.size(); },
+            "Return the number of generations.\n")
+        .def_property_readonly(
+            "completed_generations",
+            [](const file_decoder_type& d) { return d.m_completed.load(); },
+            "Return the number of completely decoded generations.\n")
+        .def_property_readonly(
+            "coefficients_bytes",
+            [](const file_decoder_type& d) { return d.m_coefficients_bytes; },
+            "Return the size of the coefficients in a packet.\n")
+        .def_property_readonly("packet_bytes", &file_decoder_type::packet_bytes,
+                               "Return the size of a packet in bytes.\n")
+        .def_property_readonly(
+            "threads",
+            [](const file_decoder_type& d) { return d.m_pool.threads(); },
+            "Return the number of threads used for decoding.\n")
+        .def("decode_packets", &block_file_decoder_decode_packets,
+             arg("packets"),
+             "Decode a batch of packets. The packets are grouped by "
+             "generation and the generations are decoded in parallel. Packets "
+             "for already decoded generations are ignored.\n\n"
+             "\t:param packets: A buffer containing whole packets.\n"
+             "\t:return: A list of the generations completed by this call.\n")
+        .def("is_generation_complete",
+             &block_file_decoder_is_generation_complete, arg("generation"),
+             "Return True if the generation is completely decoded and written "
+             "to the file.\n\n"
+             "\t:param generation: The index of the generation.\n")
+        .def("generation_rank", &block_file_decoder_generation_rank,
+             arg("generation"),
+             "Return the rank of a generation.\n\n"
+             "\t:param generation: The index of the generation.\n")
+        .def(
+            "is_complete",
+            [](const file_decoder_type& d)
+            { return d.m_completed == d.m_generations.size(); },
+            "Return True if all generations are decoded.\n")
+        .def("flush", &block_file_decoder_flush,
+             "Flush the decoded data to the file.\n");
+}
+}
+}
+}
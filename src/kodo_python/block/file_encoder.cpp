@@ -0,0 +1,314 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "file_encoder.hpp"
+#include "file_packet.hpp"
+
+#include "../buffer.hpp"
+#include "../coefficients_bytes.hpp"
+#include "../mapped_file.hpp"
+#include "../thread_pool.hpp"
+#include "../version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <kodo/block/encoder.hpp>
+#include <kodo/block/generator/random_uniform.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace block
+{
+/// The coder state of a single generation of the file
+struct file_encoder_generation
+{
+    file_encoder_generation(kodo::finite_field field) :
+        m_encoder(field), m_generator(field)
+    {
+    }
+
+    kodo::block::encoder m_encoder;
+    kodo::block::generator::random_uniform m_generator;
+
+    /// Zero padded copy of the last generation if it is not full
+    std::vector<uint8_t> m_padded;
+
+    /// The index of the next systematic symbol to send
+    std::size_t m_systematic_index = 0;
+};
+
+struct file_encoder_type
+{
+    file_encoder_type(const std::string& path, kodo::finite_field field,
+                      std::size_t symbols, std::size_t symbol_bytes,
+                      std::size_t threads) :
+        m_file(path),
+        m_pool(threads), m_field(field), m_symbols(symbols),
+        m_symbol_bytes(symbol_bytes),
+        m_coefficients_bytes(coefficients_bytes(field, symbols))
+    {
+        if (symbols == 0)
+        {
+            throw pybind11::value_error("symbols: must be greater than zero");
+        }
+        if (symbol_bytes == 0)
+        {
+            throw pybind11::value_error(
+                "symbol_bytes: must be greater than zero");
+        }
+        if (m_file.size() == 0)
+        {
+            throw pybind11::value_error("path: the file is empty");
+        }
+
+        std::size_t generation_bytes = symbols * symbol_bytes;
+        std::size_t generations =
+            (m_file.size() + generation_bytes - 1) / generation_bytes;
+
+        if (generations > file_packet::coded_index)
+        {
+            throw pybind11::value_error(
+                "symbols: too many generations, increase symbols or "
+                "symbol_bytes");
+        }
+
+        // Different encoders of the same file produce different coded
+        // symbols
+        std::random_device random;
+        uint64_t seed = (uint64_t)random() << 32 | random();
+
+        m_generations.reserve(generations);
+        for (std::size_t i = 0; i < generations; ++i)
+        {
+            auto generation = std::make_unique<file_encoder_generation>(field);
+            generation->m_encoder.configure(symbols, symbol_bytes);
+            generation->m_generator.configure(symbols);
+            generation->m_generator.set_seed(seed + i);
+
+            std::size_t offset = i * generation_bytes;
+            std::size_t remaining = m_file.size() - offset;
+
+            if (remaining < generation_bytes)
+            {
+                generation->m_padded.resize(generation_bytes);
+                std::memcpy(generation->m_padded.data(),
+                            m_file.data() + offset, remaining);
+                generation->m_encoder.set_symbols_storage(
+                    generation->m_padded.data());
+            }
+            else
+            {
+                generation->m_encoder.set_symbols_storage(m_file.data() +
+                                                          offset);
+            }
+            m_generations.push_back(std::move(generation));
+        }
+    }
+
+    auto packet_bytes() const -> std::size_t
+    {
+        return file_packet::packet_bytes(m_coefficients_bytes, m_symbol_bytes);
+    }
+
+    mapped_file m_file;
+    thread_pool m_pool;
+    kodo::finite_field m_field;
+    std::size_t m_symbols;
+    std::size_t m_symbol_bytes;
+    std::size_t m_coefficients_bytes;
+    std::vector<std::unique_ptr<file_encoder_generation>> m_generations;
+};
+
+void block_file_encoder_encode_packet(file_encoder_type& encoder,
+                                      uint32_t generation_id, uint8_t* packet)
+{
+    auto& generation = *encoder.m_generations[generation_id];
+    uint8_t* coefficients = file_packet::coefficients(packet);
+    uint8_t* symbol =
+        file_packet::symbol(packet, encoder.m_coefficients_bytes);
+
+    if (generation.m_systematic_index < encoder.m_symbols)
+    {
+        auto index = generation.m_systematic_index++;
+        file_packet::write_header(packet, generation_id, (uint32_t)index);
+        std::memset(coefficients, 0, encoder.m_coefficients_bytes);
+        generation.m_encoder.encode_systematic_symbol(symbol, index);
+    }
+    else
+    {
+        file_packet::write_header(packet, generation_id,
+                                  file_packet::coded_index);
+        generation.m_generator.generate(coefficients);
+        generation.m_encoder.encode_symbol(symbol, coefficients);
+    }
+}
+
+auto block_file_encoder_encode_packets(file_encoder_type& encoder,
+                                       std::size_t count,
+                                       pybind11::object generations,
+                                       pybind11::object packets)
+    -> pybind11::object
+{
+    std::vector<uint32_t> generation_ids;
+
+    if (generations.is_none())
+    {
+        generation_ids.resize(encoder.m_generations.size());
+        for (std::size_t i = 0; i < generation_ids.size(); ++i)
+        {
+            generation_ids[i] = (uint32_t)i;
+        }
+    }
+    else
+    {
+        // Each generation must only appear once as the generations are
+        // encoded in parallel
+        std::vector<bool> seen(encoder.m_generations.size());
+        for (auto item : generations)
+        {
+            auto id = item.cast<std::size_t>();
+            if (id >= encoder.m_generations.size())
+            {
+                throw pybind11::value_error(
+                    "generations: must be less than FileEncoder.generations");
+            }
+            if (seen[id])
+            {
+                throw pybind11::value_error(
+                    "generations: must not contain duplicates");
+            }
+            seen[id] = true;
+            generation_ids.push_back((uint32_t)id);
+        }
+    }
+
+    auto packet_bytes = encoder.packet_bytes();
+    auto total_bytes = generation_ids.size() * count * packet_bytes;
+
+    if (packets.is_none())
+    {
+        packets = make_bytearray(total_bytes);
+    }
+
+    buffer_view packets_view(packets, true, "packets");
+
+    if (packets_view.size() < total_bytes)
+    {
+        throw pybind11::value_error(
+            "packets: not large enough to contain the packets");
+    }
+
+    {
+        pybind11::gil_scoped_release release;
+        encoder.m_pool.parallel_for(
+            generation_ids.size(),
+            [&](std::size_t i)
+            {
+                uint8_t* packet =
+                    packets_view.data() + i * count * packet_bytes;
+
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    block_file_encoder_encode_packet(
+                        encoder, generation_ids[i], packet);
+                    packet += packet_bytes;
+                }
+            });
+    }
+    return packets;
+}
+
+void file_encoder(pybind11::module& m)
+{
+    using namespace pybind11;
+    class_<file_encoder_type>(
+        m, "FileEncoder",
+        "Encodes a file of any size by splitting it into generations of "
+        "symbols * symbol_bytes bytes, each encoded with a block encoder. "
+        "The last generation is zero padded.\n\n"
+        "Packets are laid out as a little endian u32 generation, a u32 "
+        "systematic symbol index (0xFFFFFFFF for coded symbols), "
+        "coefficients_bytes coefficients and symbol_bytes symbol data. "
+        "The first symbols packets of a generation are systematic.\n")
+        .def(init<const std::string&, kodo::finite_field, std::size_t,
+                  std::size_t, std::size_t>(),
+             arg("path"), arg("field"), arg("symbols"), arg("symbol_bytes"),
+             arg("threads") = 0,
+             "The file encoder constructor. The file is memory mapped and "
+             "must not be modified while the encoder exists.\n\n"
+             "\t:param path: The path of the file to encode.\n"
+             "\t:param field: The finite field to use.\n"
+             "\t:param symbols: The number of symbols in a generation.\n"
+             "\t:param symbol_bytes: The size of a symbol in bytes.\n"
+             "\t:param threads: The number of threads used for encoding, zero "
+             "selects the number of hardware threads.\n")
+        .def_property_readonly(
+            "field", [](const file_encoder_type& e) { return e.m_field; },
+            "Return the :class:`~kodo.FiniteField` used.\n")
+        .def_property_readonly(
+            "symbols", [](const file_encoder_type& e) { return e.m_symbols; },
+            "Return the number of symbols in a generation.\n")
+        .def_property_readonly(
+            "symbol_bytes",
+            [](const file_encoder_type& e) { return e.m_symbol_bytes; },
+            "Return the size of a symbol in bytes.\n")
+        .def_property_readonly(
+            "file_bytes",
+            [](const file_encoder_type& e) { return e.m_file.size(); },
+            "Return the size of the file in bytes.\n")
+        .def_property_readonly(
+            "generations",
+            [](const file_encoder_type& e) { return e.m_generations.size(); },
+            "Return the number of generations.\n")
+        .def_property_readonly(
+            "coefficients_bytes",
+            [](const file_encoder_type& e) { return e.m_coefficients_bytes; },
+            "Return the size of the coefficients in a packet.\n")
+        .def_property_readonly("packet_bytes", &file_encoder_type::packet_bytes,
+                               "Return the size of a packet in bytes.\n")
+        .def_property_readonly(
+            "threads",
+            [](const file_encoder_type& e) { return e.m_pool.threads(); },
+            "Return the number of threads used for encoding.\n")
+        .def("encode_packets", &block_file_encoder_encode_packets,
+             arg("count"), arg("generations") = none(),
+             arg("packets") = none(),
+             "Encode count packets for each of the given generations in "
+             "parallel. The packets of generations[i] start at "
+             "packets[i * count * packet_bytes].\n\n"
+             "\t:param count: The number of packets per generation.\n"
+             "\t:param generations: An optional sequence of generation "
+             "indices, if None all generations are encoded.\n"
+             "\t:param packets: An optional writable buffer for the packets. "
+             "If None a bytearray is allocated.\n"
+             "\t:return: The buffer containing the packets.\n");
+}
+}
+}
+}
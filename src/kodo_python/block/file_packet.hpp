@@ -0,0 +1,100 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstdint>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace block
+{
+/// The packets of the FileEncoder and FileDecoder are laid out as:
+///
+///   u32 generation | u32 index | coefficients | symbol
+///
+/// with little endian integers. The index is the index of a systematic
+/// symbol, or coded_index for a coded symbol in which case the coefficients
+/// follow. The coefficients are present in all packets to keep the packet
+/// size fixed.
+namespace file_packet
+{
+/// The index of a coded symbol
+static const uint32_t coded_index = 0xFFFFFFFF;
+
+/// The size of the header in bytes
+static const std::size_t header_bytes = 8;
+
+/// @return The size of a packet in bytes
+inline std::size_t packet_bytes(std::size_t coefficients_bytes,
+                                std::size_t symbol_bytes)
+{
+    return header_bytes + coefficients_bytes + symbol_bytes;
+}
+
+inline void write_u32(uint8_t* data, uint32_t value)
+{
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+    data[2] = static_cast<uint8_t>(value >> 16);
+    data[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline uint32_t read_u32(const uint8_t* data)
+{
+    return static_cast<uint32_t>(data[0]) |
+           static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 |
+           static_cast<uint32_t>(data[3]) << 24;
+}
+
+inline void write_header(uint8_t* packet, uint32_t generation, uint32_t index)
+{
+    write_u32(packet, generation);
+    write_u32(packet + 4, index);
+}
+
+inline uint32_t generation(const uint8_t* packet)
+{
+    return read_u32(packet);
+}
+
+inline uint32_t index(const uint8_t* packet)
+{
+    return read_u32(packet + 4);
+}
+
+inline uint8_t* coefficients(uint8_t* packet)
+{
+    return packet + header_bytes;
+}
+
+inline uint8_t* symbol(uint8_t* packet, std::size_t coefficients_bytes)
+{
+    return packet + header_bytes + coefficients_bytes;
+}
+}
+}
+}
+}
@@ -56,6 +56,7 @@ void generator_parity_2d_enable_log(
     generator.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             parity_2d_type* generator = static_cast<parity_2d_type*>(data);
             assert(generator->m_log_callback);
             generator->m_log_callback(name, message);
@@ -69,7 +70,11 @@ auto block_generator_parity_2d_generate(parity_2d_type& generator)
 
     std::vector<uint8_t> coefficients(generator.max_coefficients_bytes());
 
-    auto position = generator.generate(coefficients.data());
+    std::size_t position;
+    {
+        pybind11::gil_scoped_release release;
+        position = generator.generate(coefficients.data());
+    }
 
     pybind11::tuple returns = pybind11::make_tuple(
         pybind11::bytearray{(char*)coefficients.data(), coefficients.size()},
@@ -85,7 +90,10 @@ auto block_generator_parity_2d_generate_specific(parity_2d_type& generator,
 
     std::vector<uint8_t> coefficients(generator.max_coefficients_bytes());
 
-    generator.generate_specific(coefficients.data(), position);
+    {
+        pybind11::gil_scoped_release release;
+        generator.generate_specific(coefficients.data(), position);
+    }
 
     return pybind11::bytearray{(char*)coefficients.data(), coefficients.size()};
 }
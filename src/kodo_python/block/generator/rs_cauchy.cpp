@@ -41,17 +41,6 @@ namespace block
 {
 namespace generator
 {
-struct rs_cauchy_wrapper : kodo::block::generator::rs_cauchy
-{
-    rs_cauchy_wrapper(kodo::finite_field field) :
-        kodo::block::generator::rs_cauchy(field)
-    {
-    }
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using rs_cauchy_type = rs_cauchy_wrapper;
-
 void generator_rs_cauchy_enable_log(
     rs_cauchy_type& generator,
     std::function<void(const std::string&, const std::string&)> callback)
@@ -60,6 +49,7 @@ void generator_rs_cauchy_enable_log(
     generator.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             rs_cauchy_type* generator = static_cast<rs_cauchy_type*>(data);
             assert(generator->m_log_callback);
             generator->m_log_callback(name, message);
@@ -71,7 +61,11 @@ auto block_generator_rs_cauchy_generate(rs_cauchy_type& generator)
 {
     std::vector<uint8_t> coefficients(generator.max_coefficients_bytes());
 
-    auto index = generator.generate(coefficients.data());
+    std::size_t index;
+    {
+        pybind11::gil_scoped_release release;
+        index = generator.generate(coefficients.data());
+    }
 
     pybind11::tuple returns = pybind11::make_tuple(
         pybind11::bytearray{(char*)coefficients.data(), coefficients.size()},
@@ -93,7 +87,10 @@ auto block_generator_rs_cauchy_generate_specific(rs_cauchy_type& generator,
 
     std::vector<uint8_t> coefficients(generator.max_coefficients_bytes());
 
-    generator.generate_specific(coefficients.data(), index);
+    {
+        pybind11::gil_scoped_release release;
+        generator.generate_specific(coefficients.data(), index);
+    }
 
     return pybind11::bytearray{(char*)coefficients.data(), coefficients.size()};
 }
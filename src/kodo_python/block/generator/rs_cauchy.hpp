@@ -24,6 +24,11 @@
 
 #include <pybind11/pybind11.h>
 
+#include <kodo/block/generator/rs_cauchy.hpp>
+
+#include <functional>
+#include <string>
+
 namespace kodo_python
 {
 inline namespace STEINWURF_KODO_PYTHON_VERSION
@@ -33,6 +38,17 @@ namespace block
 namespace generator
 {
 void rs_cauchy(pybind11::module& m);
+
+struct rs_cauchy_wrapper : kodo::block::generator::rs_cauchy
+{
+    rs_cauchy_wrapper(kodo::finite_field field) :
+        kodo::block::generator::rs_cauchy(field)
+    {
+    }
+    std::function<void(const std::string&, const std::string&)> m_log_callback;
+};
+
+using rs_cauchy_type = rs_cauchy_wrapper;
 }
 }
 }
@@ -42,17 +42,6 @@ namespace block
 {
 namespace generator
 {
-struct tunable_wrapper : kodo::block::generator::tunable
-{
-    tunable_wrapper(kodo::finite_field field) :
-        kodo::block::generator::tunable(field)
-    {
-    }
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using tunable_type = tunable_wrapper;
-
 void generator_tunable_enable_log(
     tunable_type& generator,
     std::function<void(const std::string&, const std::string&)> callback)
@@ -61,6 +50,7 @@ void generator_tunable_enable_log(
     generator.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             tunable_type* generator = static_cast<tunable_type*>(data);
             assert(generator->m_log_callback);
             generator->m_log_callback(name, message);
@@ -74,7 +64,10 @@ auto block_generator_tunable_generate(tunable_type& generator, float density)
 
     std::vector<uint8_t> coefficients(generator.max_coefficients_bytes());
 
-    generator.generate(coefficients.data(), density);
+    {
+        pybind11::gil_scoped_release release;
+        generator.generate(coefficients.data(), density);
+    }
 
     return pybind11::bytearray{(char*)coefficients.data(), coefficients.size()};
 }
@@ -93,7 +86,10 @@ auto block_generator_tunable_generate_partial(tunable_type& generator,
 
     std::vector<uint8_t> coefficients(generator.max_coefficients_bytes());
 
-    generator.generate_partial(coefficients.data(), symbols, density);
+    {
+        pybind11::gil_scoped_release release;
+        generator.generate_partial(coefficients.data(), symbols, density);
+    }
 
     return pybind11::bytearray{(char*)coefficients.data(), coefficients.size()};
 }
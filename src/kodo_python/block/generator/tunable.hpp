@@ -24,6 +24,11 @@
 
 #include <pybind11/pybind11.h>
 
+#include <kodo/block/generator/tunable.hpp>
+
+#include <functional>
+#include <string>
+
 namespace kodo_python
 {
 inline namespace STEINWURF_KODO_PYTHON_VERSION
@@ -33,6 +38,17 @@ namespace block
 namespace generator
 {
 void tunable(pybind11::module& m);
+
+struct tunable_wrapper : kodo::block::generator::tunable
+{
+    tunable_wrapper(kodo::finite_field field) :
+        kodo::block::generator::tunable(field)
+    {
+    }
+    std::function<void(const std::string&, const std::string&)> m_log_callback;
+};
+
+using tunable_type = tunable_wrapper;
 }
 }
 }
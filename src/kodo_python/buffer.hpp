@@ -0,0 +1,149 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <cstdint>
+#include <string>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+/// A contiguous byte view of an object supporting the Python buffer protocol
+/// e.g. bytearray, bytes, memoryview, mmap or a numpy array.
+///
+/// The view holds a buffer export on the object for as long as it is alive.
+/// Exporting objects can neither be resized nor released while exported, so
+/// the memory behind data() stays valid. Views must be created and destroyed
+/// with the GIL held.
+class buffer_view
+{
+public:
+    buffer_view() = default;
+
+    /// @param object The object to view
+    /// @param writable True if the memory will be written to
+    /// @param name The argument name used in error messages
+    buffer_view(pybind11::handle object, bool writable,
+                const std::string& name)
+    {
+        if (!PyObject_CheckBuffer(object.ptr()))
+        {
+            throw pybind11::type_error(
+                name + ": must support the buffer protocol");
+        }
+
+        m_info = pybind11::reinterpret_borrow<pybind11::buffer>(object).request(
+            writable);
+
+        if (!is_contiguous())
+        {
+            throw pybind11::value_error(name + ": buffer must be contiguous");
+        }
+    }
+
+    /// @return The first byte of the buffer
+    uint8_t* data() const
+    {
+        return static_cast<uint8_t*>(m_info.ptr);
+    }
+
+    /// @return The size of the buffer in bytes
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(m_info.size * m_info.itemsize);
+    }
+
+    /// @param row_bytes The row size used for buffers that are not two
+    ///        dimensional
+    /// @return The number of bytes between two rows of the buffer
+    std::size_t row_stride(std::size_t row_bytes) const
+    {
+        if (m_info.ndim != 2)
+        {
+            return row_bytes;
+        }
+        return static_cast<std::size_t>(m_info.strides[0]);
+    }
+
+    /// @return True if the items of the buffer are 64 bit integers, e.g.
+    ///         an array.array("Q") or a numpy uint64 or int64 array
+    bool is_int64() const
+    {
+        if (m_info.itemsize != 8)
+        {
+            return false;
+        }
+
+        std::string format = m_info.format;
+        std::size_t start = format.find_first_not_of("@=<>!");
+        if (start == std::string::npos || format.size() != start + 1)
+        {
+            return false;
+        }
+        return std::string("QqLl").find(format[start]) != std::string::npos;
+    }
+
+private:
+    bool is_contiguous() const
+    {
+        auto expected = m_info.itemsize;
+        for (auto dimension = m_info.ndim; dimension > 0; --dimension)
+        {
+            auto extent = m_info.shape[dimension - 1];
+            if (extent != 1 && m_info.strides[dimension - 1] != expected)
+            {
+                return false;
+            }
+            expected *= extent;
+        }
+        return true;
+    }
+
+private:
+    pybind11::buffer_info m_info;
+};
+
+/// @return A new bytearray of the given size with uninitialized content
+inline auto make_bytearray(std::size_t size) -> pybind11::bytearray
+{
+    PyObject* bytearray =
+        PyByteArray_FromStringAndSize(nullptr, static_cast<Py_ssize_t>(size));
+
+    if (bytearray == nullptr)
+    {
+        throw pybind11::error_already_set();
+    }
+    return pybind11::reinterpret_steal<pybind11::bytearray>(bytearray);
+}
+
+/// @return A new zero filled array.array of count unsigned 64 bit integers
+inline auto make_uint64_array(std::size_t count) -> pybind11::object
+{
+    auto array = pybind11::module::import("array").attr("array");
+    return array("Q", pybind11::bytes(std::string(count * 8, '\0')));
+}
+}
+}
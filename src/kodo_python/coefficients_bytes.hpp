@@ -0,0 +1,60 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <kodo/finite_field.hpp>
+
+#include <cstdint>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+/// @return The number of bits used to represent an element in the field
+inline std::size_t field_bits(kodo::finite_field field)
+{
+    switch (field)
+    {
+    case kodo::finite_field::binary:
+        return 1;
+    case kodo::finite_field::binary4:
+        return 4;
+    case kodo::finite_field::binary8:
+        return 8;
+    case kodo::finite_field::binary16:
+        return 16;
+    }
+    throw pybind11::value_error("field: unknown finite field");
+}
+
+/// @return The number of bytes needed to store the coding coefficients for
+///         the given number of symbols
+inline std::size_t coefficients_bytes(kodo::finite_field field,
+                                      std::size_t symbols)
+{
+    return (symbols * field_bits(field) + 7) / 8;
+}
+}
+}
@@ -0,0 +1,420 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "executor.hpp"
+
+#include "buffer.hpp"
+#include "version.hpp"
+#include "work_stealing_pool.hpp"
+
+#include "block/decoder.hpp"
+#include "block/encoder.hpp"
+#include "fulcrum/decoder.hpp"
+#include "fulcrum/encoder.hpp"
+#include "perpetual/decoder.hpp"
+#include "perpetual/encoder.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace
+{
+struct executor_type
+{
+    explicit executor_type(std::size_t threads) : m_pool(threads)
+    {
+    }
+
+    work_stealing_pool m_pool;
+};
+
+/// The state shared between a future and the job running on the pool. It
+/// must not hold Python objects as the pool releases it without the GIL.
+struct job_state
+{
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_done = false;
+    std::exception_ptr m_error;
+};
+
+struct future_type
+{
+    future_type() : m_state(std::make_shared<job_state>())
+    {
+    }
+
+    future_type(const future_type&) = delete;
+    future_type& operator=(const future_type&) = delete;
+
+    /// The job uses the coder and buffers held by the future, so it must
+    /// finish before they are released
+    ~future_type()
+    {
+        pybind11::gil_scoped_release release;
+        wait();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_state->m_mutex);
+        m_state->m_condition.wait(lock, [this] { return m_state->m_done; });
+    }
+
+    auto wait_for(double timeout) -> bool
+    {
+        auto duration = std::chrono::duration<double>(timeout);
+        std::unique_lock<std::mutex> lock(m_state->m_mutex);
+        return m_state->m_condition.wait_for(
+            lock, duration, [this] { return m_state->m_done; });
+    }
+
+    std::shared_ptr<job_state> m_state;
+
+    /// References keeping the executor, coder and buffers alive
+    pybind11::object m_executor;
+    pybind11::object m_coder;
+    std::vector<buffer_view> m_buffers;
+
+    /// The object returned by result()
+    pybind11::object m_result;
+};
+
+template <class Coder, class Job>
+auto executor_submit(executor_type& executor, Coder& coder,
+                     std::vector<buffer_view> buffers, pybind11::object result,
+                     Job job) -> std::unique_ptr<future_type>
+{
+    std::unique_ptr<future_type> future(new future_type());
+    future->m_executor = pybind11::cast(&executor);
+    future->m_coder = pybind11::cast(&coder);
+    future->m_buffers = std::move(buffers);
+    future->m_result = result;
+
+    auto state = future->m_state;
+    executor.m_pool.submit(&coder,
+                           [state, job]()
+                           {
+                               try
+                               {
+                                   job();
+                               }
+                               catch (...)
+                               {
+                                   state->m_error = std::current_exception();
+                               }
+
+                               std::lock_guard<std::mutex> lock(state->m_mutex);
+                               state->m_done = true;
+                               state->m_condition.notify_all();
+                           });
+    return future;
+}
+
+auto future_wait(future_type& future, pybind11::object timeout) -> bool
+{
+    if (timeout.is_none())
+    {
+        pybind11::gil_scoped_release release;
+        future.wait();
+        return true;
+    }
+
+    auto seconds = timeout.cast<double>();
+    pybind11::gil_scoped_release release;
+    return future.wait_for(seconds);
+}
+
+auto future_result(future_type& future, pybind11::object timeout)
+    -> pybind11::object
+{
+    if (!future_wait(future, timeout))
+    {
+        PyErr_SetString(PyExc_TimeoutError, "the job did not finish in time");
+        throw pybind11::error_already_set();
+    }
+    if (future.m_state->m_error)
+    {
+        std::rethrow_exception(future.m_state->m_error);
+    }
+    return future.m_result;
+}
+
+auto future_done(future_type& future) -> bool
+{
+    std::lock_guard<std::mutex> lock(future.m_state->m_mutex);
+    return future.m_state->m_done;
+}
+
+template <class Encoder>
+auto executor_encode(executor_type& executor, Encoder& encoder,
+                     pybind11::buffer coefficients, pybind11::object symbol)
+    -> std::unique_ptr<future_type>
+{
+    if (symbol.is_none())
+    {
+        symbol = make_bytearray(encoder.symbol_bytes());
+    }
+
+    std::vector<buffer_view> buffers;
+    buffers.emplace_back(symbol, true, "symbol");
+    buffers.emplace_back(coefficients, false, "coefficients");
+
+    if (buffers[0].size() < encoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    uint8_t* symbol_data = buffers[0].data();
+    uint8_t* coefficients_data = buffers[1].data();
+
+    return executor_submit(
+        executor, encoder, std::move(buffers), symbol,
+        [&encoder, symbol_data, coefficients_data]()
+        { encoder.encode_symbol(symbol_data, coefficients_data); });
+}
+
+auto executor_encode_perpetual(executor_type& executor,
+                               perpetual::encoder_type& encoder,
+                               uint64_t coefficients, std::size_t offset,
+                               pybind11::object symbol)
+    -> std::unique_ptr<future_type>
+{
+    if (offset >= encoder.symbols())
+    {
+        throw pybind11::value_error("offset: must be less than symbols");
+    }
+
+    if (symbol.is_none())
+    {
+        symbol = make_bytearray(encoder.symbol_bytes());
+    }
+
+    std::vector<buffer_view> buffers;
+    buffers.emplace_back(symbol, true, "symbol");
+
+    if (buffers[0].size() < encoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    uint8_t* symbol_data = buffers[0].data();
+
+    return executor_submit(
+        executor, encoder, std::move(buffers), symbol,
+        [&encoder, symbol_data, coefficients, offset]()
+        { encoder.encode_symbol(symbol_data, coefficients, offset); });
+}
+
+template <class Decoder>
+auto executor_decode(executor_type& executor, Decoder& decoder,
+                     pybind11::buffer symbol, pybind11::buffer coefficients)
+    -> std::unique_ptr<future_type>
+{
+    std::vector<buffer_view> buffers;
+    buffers.emplace_back(symbol, true, "symbol");
+    buffers.emplace_back(coefficients, true, "coefficients");
+
+    if (buffers[0].size() < decoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    uint8_t* symbol_data = buffers[0].data();
+    uint8_t* coefficients_data = buffers[1].data();
+
+    return executor_submit(
+        executor, decoder, std::move(buffers), pybind11::none(),
+        [&decoder, symbol_data, coefficients_data]()
+        { decoder.decode_symbol(symbol_data, coefficients_data); });
+}
+
+auto executor_decode_perpetual(executor_type& executor,
+                               perpetual::decoder_type& decoder,
+                               pybind11::buffer symbol, uint64_t coefficients,
+                               std::size_t offset)
+    -> std::unique_ptr<future_type>
+{
+    if (offset >= decoder.symbols())
+    {
+        throw pybind11::value_error("offset: must be less than symbols");
+    }
+
+    std::vector<buffer_view> buffers;
+    buffers.emplace_back(symbol, true, "symbol");
+
+    if (buffers[0].size() < decoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    uint8_t* symbol_data = buffers[0].data();
+
+    return executor_submit(
+        executor, decoder, std::move(buffers), pybind11::none(),
+        [&decoder, symbol_data, coefficients, offset]()
+        {
+            decoder.decode_symbol_with_stats(symbol_data, coefficients,
+                                             offset);
+        });
+}
+
+template <class Decoder>
+auto executor_recode(executor_type& executor, Decoder& decoder,
+                     pybind11::buffer coefficients_in,
+                     pybind11::buffer coefficients, pybind11::object symbol)
+    -> std::unique_ptr<future_type>
+{
+    if (symbol.is_none())
+    {
+        symbol = make_bytearray(decoder.symbol_bytes());
+    }
+
+    std::vector<buffer_view> buffers;
+    buffers.emplace_back(symbol, true, "symbol");
+    buffers.emplace_back(coefficients, true, "coefficients");
+    buffers.emplace_back(coefficients_in, false, "coefficients_in");
+
+    if (buffers[0].size() < decoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    uint8_t* symbol_data = buffers[0].data();
+    uint8_t* coefficients_data = buffers[1].data();
+    uint8_t* coefficients_in_data = buffers[2].data();
+
+    return executor_submit(
+        executor, decoder, std::move(buffers), symbol,
+        [&decoder, symbol_data, coefficients_data, coefficients_in_data]()
+        {
+            decoder.recode_symbol(symbol_data, coefficients_data,
+                                  coefficients_in_data);
+        });
+}
+}
+
+void executor(pybind11::module& m)
+{
+    using namespace pybind11;
+
+    class_<future_type>(m, "Future",
+                        "The result of a job submitted to an "
+                        ":class:`~kodo.Executor`. Releasing a future waits "
+                        "for its job to finish.\n")
+        .def("done", &future_done,
+             "Return True if the job has finished, otherwise False.\n")
+        .def("wait", &future_wait, arg("timeout") = none(),
+             "Wait for the job to finish.\n\n"
+             "\t:param timeout: An optional timeout in seconds.\n"
+             "\t:return: True if the job finished, False if the timeout "
+             "expired.\n")
+        .def("result", &future_result, arg("timeout") = none(),
+             "Wait for the job to finish and return its result. Errors raised "
+             "by the job are raised here.\n\n"
+             "\t:param timeout: An optional timeout in seconds, TimeoutError "
+             "is raised if it expires.\n"
+             "\t:return: The symbol buffer for encode and recode jobs, None "
+             "for decode jobs.\n");
+
+    class_<executor_type>(
+        m, "Executor",
+        "Runs encode, decode and recode jobs on a pool of native worker "
+        "threads without holding the GIL. Idle workers steal jobs from busy "
+        "ones. Jobs using the same coder run one at a time in the order they "
+        "were submitted, jobs of different coders run in parallel. The "
+        "coders and buffers of a job are kept alive, and buffers exported, "
+        "until its future is released. Coders must not be used directly "
+        "while they have unfinished jobs.\n")
+        .def(init<std::size_t>(), arg("threads") = 0,
+             "The executor constructor.\n\n"
+             "\t:param threads: The number of worker threads, zero selects "
+             "the number of hardware threads.\n")
+        .def_property_readonly(
+            "threads",
+            [](const executor_type& executor)
+            { return executor.m_pool.threads(); },
+            "Return the number of worker threads.\n")
+        .def("encode", &executor_encode<block::encoder_type>, arg("encoder"),
+             arg("coefficients"), arg("symbol") = none(),
+             "Submit a job encoding a symbol.\n\n"
+             "\t:param encoder: A block, fulcrum or perpetual encoder.\n"
+             "\t:param coefficients: The coding coefficients, for the "
+             "perpetual encoder an int.\n"
+             "\t:param offset: Only for the perpetual encoder, the offset of "
+             "the coefficients.\n"
+             "\t:param symbol: An optional writable buffer for the symbol. If "
+             "None a bytearray is allocated.\n"
+             "\t:return: A :class:`~kodo.Future` with the symbol as result.\n")
+        .def("encode", &executor_encode<fulcrum::encoder_type>,
+             arg("encoder"), arg("coefficients"), arg("symbol") = none())
+        .def("encode", &executor_encode_perpetual, arg("encoder"),
+             arg("coefficients"), arg("offset"), arg("symbol") = none())
+        .def("decode", &executor_decode<block::decoder_type>, arg("decoder"),
+             arg("symbol"), arg("coefficients"),
+             "Submit a job decoding a symbol. The symbol and coefficients are "
+             "modified by the decoder.\n\n"
+             "\t:param decoder: A block, fulcrum or perpetual decoder.\n"
+             "\t:param symbol: The writable buffer containing the symbol.\n"
+             "\t:param coefficients: The coding coefficients, for the "
+             "perpetual decoder an int.\n"
+             "\t:param offset: Only for the perpetual decoder, the offset of "
+             "the coefficients.\n"
+             "\t:return: A :class:`~kodo.Future` with None as result.\n")
+        .def("decode", &executor_decode<fulcrum::decoder_type>,
+             arg("decoder"), arg("symbol"), arg("coefficients"))
+        .def("decode", &executor_decode_perpetual, arg("decoder"),
+             arg("symbol"), arg("coefficients"), arg("offset"))
+        .def("recode", &executor_recode<block::decoder_type>, arg("decoder"),
+             arg("coefficients_in"), arg("coefficients"),
+             arg("symbol") = none(),
+             "Submit a job recoding a symbol. The perpetual codec does not "
+             "support recoding.\n\n"
+             "\t:param decoder: A block or fulcrum decoder.\n"
+             "\t:param coefficients_in: The coefficients from the generator's "
+             "generate_recode().\n"
+             "\t:param coefficients: The writable buffer for the resulting "
+             "coding coefficients.\n"
+             "\t:param symbol: An optional writable buffer for the symbol. If "
+             "None a bytearray is allocated.\n"
+             "\t:return: A :class:`~kodo.Future` with the symbol as result.\n")
+        .def("recode", &executor_recode<fulcrum::decoder_type>,
+             arg("decoder"), arg("coefficients_in"), arg("coefficients"),
+             arg("symbol") = none());
+}
+}
+}
@@ -19,7 +19,11 @@
 // See accompanying file LICENSE.rst or https://www.steinwurf.com/license
 
 #include "decoder.hpp"
+#include "generator/random_uniform.hpp"
 
+#include "../buffer.hpp"
+#include "../coefficients_bytes.hpp"
+#include "../memory_view.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
@@ -46,6 +50,7 @@ void fulcrum_decoder_enable_log(
     decoder.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             decoder_type* decoder = static_cast<decoder_type*>(data);
             assert(decoder->m_log_callback);
             decoder->m_log_callback(name, message);
@@ -54,21 +59,60 @@ void fulcrum_decoder_enable_log(
 }
 
 void fulcrum_decoder_decode_symbol(decoder_type& decoder,
-                                   pybind11::bytearray symbol,
-                                   pybind11::bytearray coefficients)
+                                   pybind11::buffer symbol,
+                                   pybind11::buffer coefficients)
 {
-    if (symbol.size() < decoder.symbol_bytes())
+    buffer_view symbol_view(symbol, true, "symbol");
+    buffer_view coefficients_view(coefficients, true, "coefficients");
+
+    if (symbol_view.size() < decoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    pybind11::gil_scoped_release release;
+    decoder.decode_symbol(symbol_view.data(), coefficients_view.data());
+}
+
+void fulcrum_decoder_decode_symbol_with_seed(
+    decoder_type& decoder, generator::random_uniform_type& generator,
+    uint64_t seed, pybind11::buffer symbol)
+{
+    // The decoder reads the coefficients of all inner symbols, so a
+    // generator configured with a smaller expansion would be over-read
+    if (generator.field() != decoder.inner_field())
+    {
+        throw pybind11::value_error(
+            "generator: must use the inner field of the decoder");
+    }
+    if (generator.symbols() != decoder.symbols() ||
+        generator.max_coefficients_bytes() <
+            coefficients_bytes(decoder.inner_field(), decoder.inner_symbols()))
+    {
+        throw pybind11::value_error(
+            "generator: must be configured with Decoder.symbols and "
+            "Decoder.expansion");
+    }
+
+    buffer_view symbol_view(symbol, true, "symbol");
+
+    if (symbol_view.size() < decoder.symbol_bytes())
     {
         throw pybind11::value_error(
             "symbol: not large enough to contain symbol");
     }
 
-    decoder.decode_symbol((uint8_t*)PyByteArray_AsString(symbol.ptr()),
-                          (uint8_t*)PyByteArray_AsString(coefficients.ptr()));
+    decoder.m_coefficients.resize(generator.max_coefficients_bytes());
+
+    pybind11::gil_scoped_release release;
+    generator.set_seed(seed);
+    generator.generate(decoder.m_coefficients.data());
+    decoder.decode_symbol(symbol_view.data(), decoder.m_coefficients.data());
 }
 
 void fulcrum_decoder_decode_systematic_symbol(decoder_type& decoder,
-                                              pybind11::bytearray symbol,
+                                              pybind11::buffer symbol,
                                               std::size_t index)
 {
     if (index >= decoder.symbols())
@@ -76,19 +120,50 @@ void fulcrum_decoder_decode_systematic_symbol(decoder_type& decoder,
         throw pybind11::value_error("index: must be less than symbols");
     }
 
-    decoder.decode_systematic_symbol(
-        (const uint8_t*)PyByteArray_AsString(symbol.ptr()), index);
+    buffer_view symbol_view(symbol, false, "symbol");
+
+    if (symbol_view.size() < decoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    pybind11::gil_scoped_release release;
+    decoder.decode_systematic_symbol(symbol_view.data(), index);
+}
+
+void fulcrum_decoder_configure(decoder_type& decoder, std::size_t symbols,
+                               std::size_t symbol_bytes, std::size_t expansion)
+{
+    decoder.configure(symbols, symbol_bytes, expansion);
+    decoder.release_storage();
+}
+
+void fulcrum_decoder_reset(decoder_type& decoder)
+{
+    decoder.reset();
+    decoder.release_storage();
 }
 
 void fulcrum_decoder_set_symbols_storage(decoder_type& decoder,
-                                         pybind11::bytearray symbols_storage)
+                                         pybind11::buffer symbols_storage)
 {
-    decoder.set_symbols_storage(
-        (uint8_t*)PyByteArray_AsString(symbols_storage.ptr()));
+    buffer_view storage(symbols_storage, true, "symbols_storage");
+
+    if (storage.size() < decoder.block_bytes())
+    {
+        throw pybind11::value_error(
+            "symbols_storage: not large enough to contain block_bytes");
+    }
+
+    decoder.set_symbols_storage(storage.data());
+    decoder.release_storage();
+    decoder.m_symbols_storage =
+        std::make_shared<buffer_view>(std::move(storage));
 }
 
 void fulcrum_decoder_set_symbol_storage(decoder_type& decoder,
-                                        pybind11::bytearray symbol_storage,
+                                        pybind11::buffer symbol_storage,
                                         std::size_t index)
 {
     if (index >= decoder.symbols())
@@ -96,25 +171,38 @@ void fulcrum_decoder_set_symbol_storage(decoder_type& decoder,
         throw pybind11::value_error("index: must be less than symbols");
     }
 
-    decoder.set_symbol_storage(
-        (uint8_t*)PyByteArray_AsString(symbol_storage.ptr()), index);
+    buffer_view storage(symbol_storage, true, "symbol_storage");
+
+    if (storage.size() < decoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol_storage: not large enough to contain symbol_bytes");
+    }
+
+    decoder.set_symbol_storage(storage.data(), index);
+    decoder.m_symbol_storage[index] =
+        std::make_shared<buffer_view>(std::move(storage));
 }
 
 void fulcrum_decoder_recode_symbol(decoder_type& decoder,
-                                   pybind11::bytearray symbol,
-                                   pybind11::bytearray coefficients,
-                                   pybind11::bytearray coefficients_in)
+                                   pybind11::buffer symbol,
+                                   pybind11::buffer coefficients,
+                                   pybind11::buffer coefficients_in)
 {
-    if (symbol.size() < decoder.symbol_bytes())
+    buffer_view symbol_view(symbol, true, "symbol");
+    buffer_view coefficients_view(coefficients, true, "coefficients");
+    buffer_view coefficients_in_view(coefficients_in, false,
+                                     "coefficients_in");
+
+    if (symbol_view.size() < decoder.symbol_bytes())
     {
         throw pybind11::value_error(
             "symbol: not large enough to contain symbol");
     }
 
-    decoder.recode_symbol(
-        (uint8_t*)PyByteArray_AsString(symbol.ptr()),
-        (uint8_t*)PyByteArray_AsString(coefficients.ptr()),
-        (const uint8_t*)PyByteArray_AsString(coefficients_in.ptr()));
+    pybind11::gil_scoped_release release;
+    decoder.recode_symbol(symbol_view.data(), coefficients_view.data(),
+                          coefficients_in_view.data());
 }
 
 auto fulcrum_decoder_symbol_data(decoder_type& decoder, std::size_t index)
@@ -128,6 +216,44 @@ auto fulcrum_decoder_symbol_data(decoder_type& decoder, std::size_t index)
     return pybind11::bytearray{(const char*)symbol, decoder.symbol_bytes()};
 }
 
+auto fulcrum_decoder_symbol_view(decoder_type& decoder, std::size_t index)
+    -> pybind11::memoryview
+{
+    if (index >= decoder.symbols())
+    {
+        throw pybind11::value_error("index: must be less than symbols");
+    }
+    auto symbol = decoder.symbol_data(index);
+    if (symbol == nullptr)
+    {
+        throw pybind11::value_error("index: symbol storage not set");
+    }
+    return make_memoryview(pybind11::cast(&decoder), symbol,
+                           decoder.symbol_bytes(),
+                           decoder.storage_export(index));
+}
+
+auto fulcrum_decoder_symbols_view(decoder_type& decoder)
+    -> pybind11::memoryview
+{
+    const uint8_t* data = decoder.symbol_data(0);
+    if (data == nullptr)
+    {
+        throw pybind11::value_error("symbols storage not set");
+    }
+    for (std::size_t index = 1; index < decoder.symbols(); ++index)
+    {
+        if (decoder.symbol_data(index) != data + index * decoder.symbol_bytes())
+        {
+            throw pybind11::value_error(
+                "symbols storage is not contiguous, use symbol_view");
+        }
+    }
+    return make_memoryview(pybind11::cast(&decoder), data,
+                           decoder.block_bytes(),
+                           decoder.storage_exports());
+}
+
 void decoder(pybind11::module& m)
 {
     using namespace pybind11;
@@ -135,7 +261,7 @@ void decoder(pybind11::module& m)
         .def(init<kodo::finite_field>(), arg("field"),
              "The fulcrum decoder constructor\n\n"
              "\t:param field: the chosen finite field.\n")
-        .def("configure", &decoder_type::configure, arg("symbols"),
+        .def("configure", &fulcrum_decoder_configure, arg("symbols"),
              arg("symbol_bytes"), arg("expansion"),
              "Configure the decoder with the given parameters. This is also "
              "useful for reusing an existing coder. Note that the "
@@ -144,7 +270,9 @@ void decoder(pybind11::module& m)
              "\t:param symbols: The number of symbols.\n"
              "\t:param symbol_bytes: The size of a symbol in bytes.\n"
              "\t:param expansion: The number of expansion symbols to use.\n")
-        .def("reset", &decoder_type::reset, "Reset the state of the decoder.\n")
+        .def("reset", &fulcrum_decoder_reset,
+             "Reset the state of the decoder. The symbol storage is released "
+             "and must be set again.\n")
         .def_property_readonly(
             "symbols", &decoder_type::symbols,
             "Return the number of symbols supported by this decoder.\n")
@@ -170,9 +298,11 @@ void decoder(pybind11::module& m)
                                "Return the rank of the inner decoder.\n")
         .def("set_symbols_storage", &fulcrum_decoder_set_symbols_storage,
              arg("symbols_storage"),
-             "Set the symbols to be decoded.\n\n"
-             "\t:param symbols_storage: The buffer containing all the data for "
-             "the block.\n")
+             "Set the symbols to be decoded. The buffer is kept exported, i.e. "
+             "it cannot be resized, until the decoder is reconfigured or "
+             "destroyed.\n\n"
+             "\t:param symbols_storage: The writable buffer e.g. a bytearray, "
+             "mmap or numpy array where the block will be decoded.\n")
         .def("set_symbol_storage", &fulcrum_decoder_set_symbol_storage,
              arg("symbol_storage"), arg("index"),
              "Set a symbol to be decoded.\n\n"
@@ -187,6 +317,17 @@ void decoder(pybind11::module& m)
             "symbol. Assumed to contain at least symbol_bytes bytes.\n"
             "\t:param coefficients: The coding coefficients that describe the "
             "encoding of the symbol.\n")
+        .def("decode_symbol_with_seed",
+             &fulcrum_decoder_decode_symbol_with_seed, arg("generator"),
+             arg("seed"), arg("symbol"),
+             "Seed the generator, generate the coefficients and decode a "
+             "symbol in a single call. This is the counterpart of "
+             "Encoder.encode_symbol_with_seed().\n\n"
+             "\t:param generator: A RandomUniform generator configured with "
+             "Decoder.symbols and Decoder.expansion.\n"
+             "\t:param seed: The seed used when encoding the symbol.\n"
+             "\t:param symbol: The writable buffer containing the symbol, it "
+             "is modified by the decoder.\n")
         .def("decode_systematic_symbol",
              &fulcrum_decoder_decode_systematic_symbol, arg("symbol"),
              arg("index"),
@@ -209,6 +350,17 @@ void decoder(pybind11::module& m)
         .def("symbol_data", &fulcrum_decoder_symbol_data, arg("index"),
              "Return the bytearray containing the data of the symbol.\n\n"
              "\t:param index: The index of the symbol.\n")
+        .def("symbol_view", &fulcrum_decoder_symbol_view, arg("index"),
+             "Return a read-only memoryview of a symbol in the symbols "
+             "storage. Unlike symbol_data no copy is made, the view reflects "
+             "the storage as decoding progresses. The decoder and the "
+             "storage are kept alive and exported while the view exists, "
+             "also after the decoder is reset or reconfigured.\n\n"
+             "\t:param index: The index of the symbol.\n")
+        .def("symbols_view", &fulcrum_decoder_symbols_view,
+             "Return a read-only memoryview of the whole block. This requires "
+             "the storage to be contiguous, e.g. set with "
+             "set_symbols_storage.\n")
         .def("is_symbol_pivot", &decoder_type::is_symbol_pivot, arg("index"),
              "Return True if the decoder contains a pivot at the specific "
              "index.\n")
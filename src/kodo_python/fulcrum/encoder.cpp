@@ -19,7 +19,10 @@
 // See accompanying file LICENSE.rst or https://www.steinwurf.com/license
 
 #include "encoder.hpp"
+#include "generator/random_uniform.hpp"
 
+#include "../buffer.hpp"
+#include "../coefficients_bytes.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
@@ -37,17 +40,6 @@ inline namespace STEINWURF_KODO_PYTHON_VERSION
 {
 namespace fulcrum
 {
-
-struct encoder_wrapper : kodo::fulcrum::encoder
-{
-    encoder_wrapper(kodo::finite_field field) : kodo::fulcrum::encoder(field)
-    {
-    }
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using encoder_type = encoder_wrapper;
-
 void fulcrum_encoder_enable_log(
     encoder_type& encoder,
     std::function<void(const std::string&, const std::string&)> callback)
@@ -56,6 +48,7 @@ void fulcrum_encoder_enable_log(
     encoder.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             encoder_type* encoder = static_cast<encoder_type*>(data);
             assert(encoder->m_log_callback);
             encoder->m_log_callback(name, message);
@@ -64,16 +57,63 @@ void fulcrum_encoder_enable_log(
 }
 
 auto fulcrum_encoder_encode_symbol(encoder_type& encoder,
-                                   pybind11::bytearray coefficients)
+                                   pybind11::buffer coefficients)
     -> pybind11::bytearray
 {
-    std::vector<uint8_t> symbol(encoder.symbol_bytes());
+    buffer_view coefficients_view(coefficients, false, "coefficients");
 
-    encoder.encode_symbol(symbol.data(),
-                          (uint8_t*)PyByteArray_AsString(coefficients.ptr()));
+    std::vector<uint8_t> symbol(encoder.symbol_bytes());
+    {
+        pybind11::gil_scoped_release release;
+        encoder.encode_symbol(symbol.data(), coefficients_view.data());
+    }
     return pybind11::bytearray{(char*)symbol.data(), symbol.size()};
 }
 
+auto fulcrum_encoder_encode_symbol_with_seed(
+    encoder_type& encoder, generator::random_uniform_type& generator,
+    uint64_t seed, pybind11::object symbol) -> pybind11::object
+{
+    // The encoder reads the coefficients of all inner symbols, so a
+    // generator configured with a smaller expansion would be over-read
+    if (generator.field() != encoder.inner_field())
+    {
+        throw pybind11::value_error(
+            "generator: must use the inner field of the encoder");
+    }
+    if (generator.symbols() != encoder.symbols() ||
+        generator.max_coefficients_bytes() <
+            coefficients_bytes(encoder.inner_field(), encoder.inner_symbols()))
+    {
+        throw pybind11::value_error(
+            "generator: must be configured with Encoder.symbols and "
+            "Encoder.expansion");
+    }
+
+    if (symbol.is_none())
+    {
+        symbol = make_bytearray(encoder.symbol_bytes());
+    }
+
+    buffer_view symbol_view(symbol, true, "symbol");
+
+    if (symbol_view.size() < encoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: not large enough to contain symbol");
+    }
+
+    encoder.m_coefficients.resize(generator.max_coefficients_bytes());
+    {
+        pybind11::gil_scoped_release release;
+        generator.set_seed(seed);
+        generator.generate(encoder.m_coefficients.data());
+        encoder.encode_symbol(symbol_view.data(),
+                              encoder.m_coefficients.data());
+    }
+    return symbol;
+}
+
 auto fulcrum_encoder_encode_systematic_symbol(encoder_type& encoder,
                                               std::size_t index)
     -> pybind11::bytearray
@@ -84,26 +124,50 @@ auto fulcrum_encoder_encode_systematic_symbol(encoder_type& encoder,
     }
 
     std::vector<uint8_t> symbol(encoder.symbol_bytes());
-
-    encoder.encode_systematic_symbol(symbol.data(), index);
+    {
+        pybind11::gil_scoped_release release;
+        encoder.encode_systematic_symbol(symbol.data(), index);
+    }
 
     return pybind11::bytearray{(char*)symbol.data(), symbol.size()};
 }
 
+void fulcrum_encoder_configure(encoder_type& encoder, std::size_t symbols,
+                               std::size_t symbol_bytes, std::size_t expansion)
+{
+    encoder.configure(symbols, symbol_bytes, expansion);
+    encoder.release_storage();
+}
+
+void fulcrum_encoder_reset(encoder_type& encoder)
+{
+    encoder.reset();
+    encoder.release_storage();
+}
+
 void fulcrum_encoder_set_symbols_storage(encoder_type& encoder,
-                                         pybind11::bytearray symbols_storage)
+                                         pybind11::buffer symbols_storage)
 {
     if (encoder.rank() != 0)
     {
         throw std::runtime_error("symbol storage must only be set once");
     }
 
-    encoder.set_symbols_storage(
-        (uint8_t*)PyByteArray_AsString(symbols_storage.ptr()));
+    buffer_view storage(symbols_storage, false, "symbols_storage");
+
+    if (storage.size() < encoder.block_bytes())
+    {
+        throw pybind11::value_error(
+            "symbols_storage: not large enough to contain block_bytes");
+    }
+
+    encoder.set_symbols_storage(storage.data());
+    encoder.release_storage();
+    encoder.m_symbols_storage = std::move(storage);
 }
 
 void fulcrum_encoder_set_symbol_storage(encoder_type& encoder,
-                                        pybind11::bytearray symbol_storage,
+                                        pybind11::buffer symbol_storage,
                                         std::size_t index)
 {
     if (index >= encoder.symbols())
@@ -116,8 +180,16 @@ void fulcrum_encoder_set_symbol_storage(encoder_type& encoder,
         throw pybind11::value_error("index: symbols is already set");
     }
 
-    encoder.set_symbol_storage(
-        (uint8_t*)PyByteArray_AsString(symbol_storage.ptr()), index);
+    buffer_view storage(symbol_storage, false, "symbol_storage");
+
+    if (storage.size() < encoder.symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol_storage: not large enough to contain symbol_bytes");
+    }
+
+    encoder.set_symbol_storage(storage.data(), index);
+    encoder.m_symbol_storage[index] = std::move(storage);
 }
 
 void encoder(pybind11::module& m)
@@ -127,7 +199,7 @@ void encoder(pybind11::module& m)
         .def(init<kodo::finite_field>(), arg("field"),
              "The fulcrum encoder constructor\n\n"
              "\t:param field: the chosen finite field.\n")
-        .def("configure", &encoder_type::configure, arg("symbols"),
+        .def("configure", &fulcrum_encoder_configure, arg("symbols"),
              arg("symbol_bytes"), arg("expansion"),
              "Configure the encoder with the given parameters. This is also "
              "useful for reusing an existing coder. Note that the "
@@ -136,7 +208,9 @@ void encoder(pybind11::module& m)
              "\t:param symbols: The number of symbols.\n"
              "\t:param symbol_bytes: The size of a symbol in bytes.\n"
              "\t:param expansion: The number of expansion symbols to use.\n")
-        .def("reset", &encoder_type::reset, "Reset the state of the encoder.\n")
+        .def("reset", &fulcrum_encoder_reset,
+             "Reset the state of the encoder. The symbol storage is released "
+             "and must be set again.\n")
         .def_property_readonly(
             "symbols", &encoder_type::symbols,
             "Return the number of symbols supported by this encoder.\n")
@@ -162,9 +236,12 @@ void encoder(pybind11::module& m)
                                "Return the rank of the inner encoder.\n")
         .def("set_symbols_storage", &fulcrum_encoder_set_symbols_storage,
              arg("symbols_storage"),
-             "Set the symbols to be encoded.\n\n"
+             "Set the symbols to be encoded. The buffer is kept exported, i.e. "
+             "it cannot be resized, until the encoder is reconfigured or "
+             "destroyed.\n\n"
              "\t:param symbols_storage: The buffer containing all the data for "
-             "the block\n")
+             "the block. Any object supporting the buffer protocol can be "
+             "used e.g. bytes, bytearray, mmap or a numpy array.\n")
         .def("set_symbol_storage", &fulcrum_encoder_set_symbol_storage,
              arg("symbol_storage"), arg("index"),
              "Set a symbol to be encoded.\n\n"
@@ -181,6 +258,19 @@ void encoder(pybind11::module& m)
              "Create a new encoded symbol given the passed encoding "
              "coefficients.\n\n"
              "\t:param coefficients: The coding coefficients.\n")
+        .def("encode_symbol_with_seed",
+             &fulcrum_encoder_encode_symbol_with_seed, arg("generator"),
+             arg("seed"), arg("symbol") = none(),
+             "Seed the generator, generate the coefficients and encode a "
+             "symbol in a single call. A decoder regenerates the "
+             "coefficients from the seed with "
+             "Decoder.decode_symbol_with_seed().\n\n"
+             "\t:param generator: A RandomUniform generator configured with "
+             "Encoder.symbols and Encoder.expansion.\n"
+             "\t:param seed: The seed used for the coefficients.\n"
+             "\t:param symbol: An optional writable buffer of at least "
+             "Encoder.symbol_bytes bytes. If None a bytearray is allocated.\n"
+             "\t:return: The buffer containing the encoded symbol.\n")
         .def("encode_systematic_symbol",
              &fulcrum_encoder_encode_systematic_symbol, arg("index"),
              "Creates a new systematic, i.e, un-coded symbol given the passed "
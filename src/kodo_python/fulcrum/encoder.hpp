@@ -20,10 +20,18 @@
 
 #pragma once
 
+#include "../buffer.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
 
+#include <kodo/fulcrum/encoder.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
 namespace kodo_python
 {
 inline namespace STEINWURF_KODO_PYTHON_VERSION
@@ -31,6 +39,34 @@ inline namespace STEINWURF_KODO_PYTHON_VERSION
 namespace fulcrum
 {
 void encoder(pybind11::module& m);
+
+struct encoder_wrapper : kodo::fulcrum::encoder
+{
+    encoder_wrapper(kodo::finite_field field) : kodo::fulcrum::encoder(field)
+    {
+    }
+    std::function<void(const std::string&, const std::string&)> m_log_callback;
+
+    /// Buffer export pinning the memory given with set_symbols_storage
+    buffer_view m_symbols_storage;
+
+    /// Buffer exports pinning the memory given with set_symbol_storage, one
+    /// per symbol index
+    std::vector<buffer_view> m_symbol_storage;
+
+    /// Release the buffer exports of the symbol storage
+    void release_storage()
+    {
+        m_symbols_storage = buffer_view();
+        m_symbol_storage.clear();
+        m_symbol_storage.resize(symbols());
+    }
+
+    /// Scratch memory for the coefficients of encode_symbol_with_seed
+    std::vector<uint8_t> m_coefficients;
+};
+
+using encoder_type = encoder_wrapper;
 }
 }
 }
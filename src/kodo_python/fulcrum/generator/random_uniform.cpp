@@ -42,13 +42,6 @@ namespace fulcrum
 {
 namespace generator
 {
-struct random_uniform_wrapper : kodo::fulcrum::generator::random_uniform
-{
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using random_uniform_type = random_uniform_wrapper;
-
 void generator_random_uniform_enable_log(
     random_uniform_type& generator,
     std::function<void(const std::string&, const std::string&)> callback)
@@ -57,6 +50,7 @@ void generator_random_uniform_enable_log(
     generator.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             random_uniform_type* generator =
                 static_cast<random_uniform_type*>(data);
             assert(generator->m_log_callback);
@@ -71,7 +65,10 @@ auto fulcrum_generator_random_uniform_generate(random_uniform_type& generator)
 
     std::vector<uint8_t> coefficients(generator.max_coefficients_bytes());
 
-    generator.generate(coefficients.data());
+    {
+        pybind11::gil_scoped_release release;
+        generator.generate(coefficients.data());
+    }
     return pybind11::bytearray{(char*)coefficients.data(), coefficients.size()};
 }
 
@@ -86,7 +83,10 @@ auto fulcrum_generator_random_uniform_generate_partial(
 
     std::vector<uint8_t> coefficients(generator.max_coefficients_bytes());
 
-    generator.generate_partial(coefficients.data(), symbols);
+    {
+        pybind11::gil_scoped_release release;
+        generator.generate_partial(coefficients.data(), symbols);
+    }
     return pybind11::bytearray{(char*)coefficients.data(), coefficients.size()};
 }
 
@@ -96,7 +96,10 @@ auto fulcrum_generator_random_uniform_generate_recode(
 {
     std::vector<uint8_t> coefficients(generator.max_coefficients_bytes());
 
-    generator.generate_recode(coefficients.data(), decoder);
+    {
+        pybind11::gil_scoped_release release;
+        generator.generate_recode(coefficients.data(), decoder);
+    }
 
     return pybind11::bytearray{(char*)coefficients.data(), coefficients.size()};
 }
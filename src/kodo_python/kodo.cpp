@@ -22,29 +22,38 @@
 
 #include <sstream>
 #include <string>
+#include <system_error>
 
 #include <kodo/finite_field.hpp>
 #include <kodo/version.hpp>
 
 #include "block/decoder.hpp"
 #include "block/encoder.hpp"
+#include "block/file_decoder.hpp"
+#include "block/file_encoder.hpp"
 #include "block/generator/parity_2d.hpp"
 #include "block/generator/random_uniform.hpp"
 #include "block/generator/rs_cauchy.hpp"
 #include "block/generator/tunable.hpp"
 
+#include "executor.hpp"
 #include "finite_field.hpp"
+#include "memory_view.hpp"
 #include "version.hpp"
 
 #include "perpetual/decoder.hpp"
+#include "perpetual/depacketizer.hpp"
 #include "perpetual/encoder.hpp"
 #include "perpetual/generator/random_uniform.hpp"
 #include "perpetual/offset/random_uniform.hpp"
+#include "perpetual/packetizer.hpp"
 #include "perpetual/width.hpp"
 
+#include "slide/adaptive_rate_controller.hpp"
 #include "slide/decoder.hpp"
 #include "slide/encoder.hpp"
 #include "slide/generator/random_uniform.hpp"
+#include "slide/range.hpp"
 #include "slide/rate_controller.hpp"
 
 #include "fulcrum/decoder.hpp"
@@ -67,11 +76,43 @@ PYBIND11_MODULE(kodo, m)
     m.attr("__license__") = "Kodo Evaluation/Research License 1.2";
     m.attr("__copyright__") = "Steinwurf ApS";
 
+    // Report operating system errors, e.g. from opening files, as OSError
+    pybind11::register_exception_translator(
+        [](std::exception_ptr error)
+        {
+            try
+            {
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+            catch (const std::system_error& e)
+            {
+                if (e.code().category() == std::generic_category())
+                {
+                    // OSError selects the subclass, e.g. FileNotFoundError,
+                    // from the errno
+                    auto args = pybind11::make_tuple(e.code().value(),
+                                                     std::string(e.what()));
+                    PyErr_SetObject(PyExc_OSError, args.ptr());
+                }
+                else
+                {
+                    PyErr_SetString(PyExc_OSError, e.what());
+                }
+            }
+        });
+
     finite_field(m);
+    memory_view(m);
+    executor(m);
 
     auto block = m.def_submodule("block", "Block codec");
     block::encoder(block);
     block::decoder(block);
+    block::file_encoder(block);
+    block::file_decoder(block);
 
     auto block_generator =
         block.def_submodule("generator", "Block codec generators");
@@ -92,6 +133,8 @@ PYBIND11_MODULE(kodo, m)
     perpetual::encoder(perpetual);
     perpetual::decoder(perpetual);
     perpetual::width(perpetual);
+    perpetual::packetizer(perpetual);
+    perpetual::depacketizer(perpetual);
 
     auto perpetual_generator =
         perpetual.def_submodule("generator", "Perpetual codec generator");
@@ -102,9 +145,11 @@ PYBIND11_MODULE(kodo, m)
     perpetual::offset::random_uniform(perpetual_offset);
 
     auto slide = m.def_submodule("slide", "Sliding window codec");
+    slide::range(slide);
     slide::encoder(slide);
     slide::decoder(slide);
     slide::rate_controller(slide);
+    slide::adaptive_rate_controller(slide);
 
     auto slide_generator =
         slide.def_submodule("generator", "Sliding window codec generator");
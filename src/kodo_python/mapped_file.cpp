@@ -0,0 +1,255 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "mapped_file.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace
+{
+[[noreturn]] void throw_last_error(const std::string& what)
+{
+#if defined(_WIN32)
+    throw std::system_error(static_cast<int>(GetLastError()),
+                            std::system_category(), what);
+#else
+    throw std::system_error(errno, std::generic_category(), what);
+#endif
+}
+}
+
+mapped_file::mapped_file(const std::string& path)
+{
+    map(path, false, 0);
+}
+
+mapped_file::mapped_file(const std::string& path, std::size_t size)
+{
+    map(path, true, size);
+}
+
+mapped_file::~mapped_file()
+{
+    unmap();
+}
+
+uint8_t* mapped_file::data() const
+{
+    return m_data;
+}
+
+std::size_t mapped_file::size() const
+{
+    return m_size;
+}
+
+bool mapped_file::is_writable() const
+{
+    return m_writable;
+}
+
+#if defined(_WIN32)
+
+void mapped_file::map(const std::string& path, bool writable, std::size_t size)
+{
+    m_writable = writable;
+
+    HANDLE file = CreateFileA(
+        path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+        FILE_SHARE_READ, nullptr, writable ? CREATE_ALWAYS : OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw_last_error(path);
+    }
+    m_file = file;
+
+    if (writable)
+    {
+        m_size = size;
+    }
+    else
+    {
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            unmap();
+            throw_last_error(path);
+        }
+        m_size = static_cast<std::size_t>(file_size.QuadPart);
+    }
+
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    uint64_t mapping_size = m_size;
+    HANDLE mapping = CreateFileMappingA(
+        file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+        static_cast<DWORD>(mapping_size >> 32),
+        static_cast<DWORD>(mapping_size & 0xFFFFFFFF), nullptr);
+
+    if (mapping == nullptr)
+    {
+        unmap();
+        throw_last_error(path);
+    }
+    m_mapping = mapping;
+
+    void* data = MapViewOfFile(
+        mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, m_size);
+
+    if (data == nullptr)
+    {
+        unmap();
+        throw_last_error(path);
+    }
+    m_data = static_cast<uint8_t*>(data);
+}
+
+void mapped_file::unmap()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != nullptr)
+    {
+        CloseHandle(m_file);
+        m_file = nullptr;
+    }
+}
+
+void mapped_file::flush()
+{
+    if (m_data != nullptr && m_writable && !FlushViewOfFile(m_data, m_size))
+    {
+        throw_last_error("flush");
+    }
+}
+
+#else
+
+void mapped_file::map(const std::string& path, bool writable, std::size_t size)
+{
+    m_writable = writable;
+
+    int flags = writable ? O_RDWR | O_CREAT | O_TRUNC : O_RDONLY;
+    m_file = ::open(path.c_str(), flags, 0644);
+
+    if (m_file < 0)
+    {
+        throw_last_error(path);
+    }
+
+    if (writable)
+    {
+        if (::ftruncate(m_file, static_cast<off_t>(size)) != 0)
+        {
+            int error = errno;
+            unmap();
+            errno = error;
+            throw_last_error(path);
+        }
+        m_size = size;
+    }
+    else
+    {
+        struct stat file_stat;
+        if (::fstat(m_file, &file_stat) != 0)
+        {
+            int error = errno;
+            unmap();
+            errno = error;
+            throw_last_error(path);
+        }
+        m_size = static_cast<std::size_t>(file_stat.st_size);
+    }
+
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    void* data =
+        ::mmap(nullptr, m_size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+               MAP_SHARED, m_file, 0);
+
+    if (data == MAP_FAILED)
+    {
+        int error = errno;
+        unmap();
+        errno = error;
+        throw_last_error(path);
+    }
+    m_data = static_cast<uint8_t*>(data);
+}
+
+void mapped_file::unmap()
+{
+    if (m_data != nullptr)
+    {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    if (m_file >= 0)
+    {
+        ::close(m_file);
+        m_file = -1;
+    }
+}
+
+void mapped_file::flush()
+{
+    if (m_data != nullptr && m_writable &&
+        ::msync(m_data, m_size, MS_SYNC) != 0)
+    {
+        throw_last_error("flush");
+    }
+}
+
+#endif
+}
+}
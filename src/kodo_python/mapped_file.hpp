@@ -0,0 +1,83 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "version.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+/// A file mapped into memory. Errors are reported as std::system_error.
+class mapped_file
+{
+public:
+    /// Map an existing file read-only
+    ///
+    /// @param path The path of the file
+    explicit mapped_file(const std::string& path);
+
+    /// Create a file of the given size, or truncate an existing one, and map
+    /// it read-write
+    ///
+    /// @param path The path of the file
+    /// @param size The size of the file in bytes
+    mapped_file(const std::string& path, std::size_t size);
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file();
+
+    /// @return The first byte of the mapping or nullptr if the file is empty
+    uint8_t* data() const;
+
+    /// @return The size of the file in bytes
+    std::size_t size() const;
+
+    /// @return True if the file is mapped read-write
+    bool is_writable() const;
+
+    /// Flush the modified pages of a read-write mapping to the file
+    void flush();
+
+private:
+    void map(const std::string& path, bool writable, std::size_t size);
+
+    void unmap();
+
+private:
+    uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_writable = false;
+
+#if defined(_WIN32)
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+};
+}
+}
@@ -0,0 +1,82 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "memory_view.hpp"
+
+#include "version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace
+{
+/// Exports a piece of memory owned by another Python object through the
+/// buffer protocol. Memoryviews, including slices of them, hold a reference
+/// to the exporter which in turn holds a reference to the owner and keeps
+/// the memory valid.
+struct memory_exporter
+{
+    pybind11::object m_owner;
+    std::shared_ptr<void> m_keep_alive;
+    const uint8_t* m_data;
+    std::size_t m_size;
+};
+}
+
+auto make_memoryview(pybind11::handle owner, const uint8_t* data,
+                     std::size_t size, std::shared_ptr<void> keep_alive)
+    -> pybind11::memoryview
+{
+    auto exporter = pybind11::cast(memory_exporter{
+        pybind11::reinterpret_borrow<pybind11::object>(owner),
+        std::move(keep_alive), data, size});
+
+    PyObject* view = PyMemoryView_FromObject(exporter.ptr());
+    if (view == nullptr)
+    {
+        throw pybind11::error_already_set();
+    }
+    return pybind11::reinterpret_steal<pybind11::memoryview>(view);
+}
+
+void memory_view(pybind11::module& m)
+{
+    using namespace pybind11;
+    class_<memory_exporter>(m, "_MemoryExporter", buffer_protocol(),
+                            "Exports memory owned by a coder, use memoryview "
+                            "to access it.\n")
+        .def_buffer(
+            [](memory_exporter& exporter) -> buffer_info
+            {
+                return buffer_info(const_cast<uint8_t*>(exporter.m_data), 1,
+                                   format_descriptor<uint8_t>::format(),
+                                   static_cast<ssize_t>(exporter.m_size),
+                                   true);
+            });
+}
+}
+}
@@ -0,0 +1,48 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+void memory_view(pybind11::module& m);
+
+/// @param owner The object owning the memory, it is kept alive for as long
+///        as the returned memoryview or any slice of it exists.
+/// @param data The first byte of the memory
+/// @param size The size of the memory in bytes
+/// @param keep_alive Keeps the memory itself valid for as long as the
+///        memoryview or any slice of it exists, e.g. the export of a storage
+///        buffer or a symbol held back from reuse
+/// @return A read-only memoryview of the memory
+auto make_memoryview(pybind11::handle owner, const uint8_t* data,
+                     std::size_t size, std::shared_ptr<void> keep_alive)
+    -> pybind11::memoryview;
+}
+}
@@ -20,6 +20,8 @@
 
 #include "decoder.hpp"
 
+#include "../buffer.hpp"
+#include "../thread_cpu_time.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
@@ -27,6 +29,7 @@
 #include <kodo/perpetual/decoder.hpp>
 
 #include <cassert>
+#include <cmath>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -37,21 +40,42 @@ inline namespace STEINWURF_KODO_PYTHON_VERSION
 {
 namespace perpetual
 {
-
-struct decoder_wrapper : kodo::perpetual::decoder
+void decoder_wrapper::decode_symbol_with_stats(uint8_t* symbol,
+                                               uint64_t coefficients,
+                                               std::size_t offset)
 {
-    decoder_wrapper(kodo::perpetual::width width) :
-        kodo::perpetual::decoder(width)
+    std::size_t previous_rank = rank();
+    double start = thread_cpu_seconds();
+    decode_symbol(symbol, coefficients, offset);
+    double seconds = thread_cpu_seconds() - start;
+
+    m_stats.m_received++;
+
+    if (rank() == previous_rank)
     {
+        m_stats.m_redundant++;
     }
-    decoder_wrapper() : kodo::perpetual::decoder()
+
+    bool mapping = m_stats.m_mapping_received != 0;
+    if (!mapping && rank() >= std::ceil(mapping_threshold() * symbols()))
     {
+        m_stats.m_mapping_rank = rank();
+        m_stats.m_mapping_received = m_stats.m_received;
     }
 
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using decoder_type = decoder_wrapper;
+    if (is_complete() && rank() != previous_rank)
+    {
+        m_stats.m_completion_seconds += seconds;
+    }
+    else if (mapping)
+    {
+        m_stats.m_mapping_seconds += seconds;
+    }
+    else
+    {
+        m_stats.m_inner_seconds += seconds;
+    }
+}
 
 void perpetual_decoder_enable_log(
     decoder_type& decoder,
@@ -61,6 +85,7 @@ void perpetual_decoder_enable_log(
     decoder.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             decoder_type* decoder = static_cast<decoder_type*>(data);
             assert(decoder->m_log_callback);
             decoder->m_log_callback(name, message);
@@ -68,18 +93,47 @@ void perpetual_decoder_enable_log(
         &decoder);
 }
 
+void perpetual_decoder_configure(decoder_type& decoder,
+                                 std::size_t block_bytes,
+                                 std::size_t symbol_bytes,
+                                 std::size_t outer_interval,
+                                 std::size_t outer_segments,
+                                 double mapping_threshold)
+{
+    decoder.configure(block_bytes, symbol_bytes, outer_interval,
+                      outer_segments, mapping_threshold);
+    decoder.m_storage = buffer_view();
+    decoder.m_stats = decoder_type::stats();
+}
+
+void perpetual_decoder_reset(decoder_type& decoder)
+{
+    decoder.reset();
+    decoder.m_stats = decoder_type::stats();
+}
+
 void perpetual_decoder_set_symbols_storage(decoder_type& decoder,
-                                           pybind11::bytearray symbols_storage)
+                                           pybind11::buffer symbols_storage)
 {
-    decoder.set_symbols_storage(
-        (uint8_t*)PyByteArray_AsString(symbols_storage.ptr()));
+    buffer_view storage(symbols_storage, true, "symbols_storage");
+
+    if (storage.size() < decoder.block_bytes())
+    {
+        throw pybind11::value_error(
+            "symbols_storage: not large enough to contain block_bytes");
+    }
+
+    decoder.set_symbols_storage(storage.data());
+    decoder.m_storage = std::move(storage);
 }
 
 void perpetual_decoder_decode_symbol(decoder_type& decoder,
-                                     pybind11::bytearray symbol,
+                                     pybind11::buffer symbol,
                                      uint64_t coefficients, std::size_t offset)
 {
-    if (symbol.size() < decoder.symbol_bytes())
+    buffer_view symbol_view(symbol, true, "symbol");
+
+    if (symbol_view.size() < decoder.symbol_bytes())
     {
         throw pybind11::value_error(
             "symbol: not large enough to contain symbol");
@@ -90,8 +144,35 @@ void perpetual_decoder_decode_symbol(decoder_type& decoder,
         throw pybind11::value_error("offset: must be less than symbols");
     }
 
-    decoder.decode_symbol((uint8_t*)PyByteArray_AsString(symbol.ptr()),
-                          coefficients, offset);
+    pybind11::gil_scoped_release release;
+    decoder.decode_symbol_with_stats(symbol_view.data(), coefficients, offset);
+}
+
+auto perpetual_decoder_stats(const decoder_type& decoder) -> pybind11::dict
+{
+    const auto& stats = decoder.m_stats;
+
+    pybind11::dict result;
+    result["symbols_received"] = stats.m_received;
+    result["innovative_symbols"] = stats.m_received - stats.m_redundant;
+    result["redundant_symbols"] = stats.m_redundant;
+    result["rank"] = decoder.rank();
+    result["symbols"] = decoder.symbols();
+    result["inner_seconds"] = stats.m_inner_seconds;
+    result["mapping_seconds"] = stats.m_mapping_seconds;
+    result["completion_seconds"] = stats.m_completion_seconds;
+
+    if (stats.m_mapping_received != 0)
+    {
+        result["mapping_rank"] = stats.m_mapping_rank;
+        result["mapping_received"] = stats.m_mapping_received;
+    }
+    else
+    {
+        result["mapping_rank"] = pybind11::none();
+        result["mapping_received"] = pybind11::none();
+    }
+    return result;
 }
 
 void decoder(pybind11::module& m)
@@ -101,7 +182,7 @@ void decoder(pybind11::module& m)
         .def(init<kodo::perpetual::width>(), arg("width"),
              "The perpetual decoder constructor\n\n"
              "\t:param width: the chosen coding width.\n")
-        .def("configure", &decoder_type::configure, arg("block_bytes"),
+        .def("configure", &perpetual_decoder_configure, arg("block_bytes"),
              arg("symbol_bytes"), arg("outer_interval") = 8,
              arg("outer_segments") = 8, arg("mapping_threshold") = 0.98,
              "configure the decoder with the given parameters. This is also "
@@ -117,7 +198,8 @@ void decoder(pybind11::module& m)
              "3 * 8 = 24 symbols mixed in an outer symbol"
              "\t:param mapping_threshold: The ratio of inner symbols received "
              "at which the inner code maps to the outer code\n")
-        .def("reset", &decoder_type::reset, "Reset the state of the decoder.\n")
+        .def("reset", &perpetual_decoder_reset,
+             "Reset the state of the decoder and its statistics.\n")
         .def_property_readonly(
             "symbols", &decoder_type::symbols,
             "Return the total number of symbols, including zero symbols, data "
@@ -158,9 +240,11 @@ void decoder(pybind11::module& m)
                                "decoded with this decoder.\n")
         .def("set_symbols_storage", &perpetual_decoder_set_symbols_storage,
              arg("symbols_storage"),
-             "Initialize all the symbols in the block.\n\n"
-             "\t:param symbols_storage: The buffer containing all the data for "
-             "the block.\n")
+             "Initialize all the symbols in the block. The buffer is kept "
+             "exported, i.e. it cannot be resized, until the decoder is "
+             "reconfigured or destroyed.\n\n"
+             "\t:param symbols_storage: The writable buffer e.g. a bytearray, "
+             "mmap or numpy array where the block will be decoded.\n")
         .def("symbols_storage", &decoder_type::symbols_storage,
              "Return the memory of the block.\n")
         .def("decode_symbol", &perpetual_decoder_decode_symbol,
@@ -187,6 +271,21 @@ void decoder(pybind11::module& m)
              "Return True if the decoder is complete, when this is true the "
              "content"
              "stored in symbols_storage is decoded.\n")
+        .def("stats", &perpetual_decoder_stats,
+             "Return a snapshot of the decoding progress as a dict, useful "
+             "when tuning mapping_threshold. It contains the number of "
+             "\"symbols_received\", \"innovative_symbols\" and "
+             "\"redundant_symbols\", the current \"rank\" and \"symbols\", "
+             "and the CPU seconds spent decoding before mapping to the "
+             "outer code started (\"inner_seconds\"), after it started "
+             "(\"mapping_seconds\") and in the call completing the decoder, "
+             "which does the backward substitution "
+             "(\"completion_seconds\"). \"mapping_rank\" and "
+             "\"mapping_received\" hold the rank and the number of symbols "
+             "received when the rank reached mapping_threshold, or None "
+             "before that. Symbols decoded through a kodo.Executor are "
+             "included. The statistics are cleared by configure() and "
+             "reset().\n")
         .def(
             "enable_log", &perpetual_decoder_enable_log, arg("callback"),
             "Enable logging for the decoder.\n\n"
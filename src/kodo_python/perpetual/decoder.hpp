@@ -20,10 +20,19 @@
 
 #pragma once
 
+#include "../buffer.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
 
+#include <kodo/perpetual/decoder.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
 namespace kodo_python
 {
 inline namespace STEINWURF_KODO_PYTHON_VERSION
@@ -31,6 +40,49 @@ inline namespace STEINWURF_KODO_PYTHON_VERSION
 namespace perpetual
 {
 void decoder(pybind11::module& m);
+
+struct decoder_wrapper : kodo::perpetual::decoder
+{
+    decoder_wrapper(kodo::perpetual::width width) :
+        kodo::perpetual::decoder(width)
+    {
+    }
+    decoder_wrapper() : kodo::perpetual::decoder()
+    {
+    }
+
+    std::function<void(const std::string&, const std::string&)> m_log_callback;
+
+    /// Decode a symbol and update m_stats. Every decode path, also the
+    /// executor and the depacketizer, goes through here so stats() sees all
+    /// symbols. Called without the GIL.
+    void decode_symbol_with_stats(uint8_t* symbol, uint64_t coefficients,
+                                  std::size_t offset);
+
+    /// Buffer export pinning the memory given as symbol storage
+    buffer_view m_storage;
+
+    /// Counters and timings of decode_symbol() reported by stats()
+    struct stats
+    {
+        std::size_t m_received = 0;
+        std::size_t m_redundant = 0;
+
+        /// Thread CPU seconds spent before and after mapping to the outer
+        /// code started and in the call that completed the decoder
+        double m_inner_seconds = 0.0;
+        double m_mapping_seconds = 0.0;
+        double m_completion_seconds = 0.0;
+
+        /// Rank and symbols received when mapping started
+        std::size_t m_mapping_rank = std::numeric_limits<std::size_t>::max();
+        std::size_t m_mapping_received = 0;
+    };
+
+    stats m_stats;
+};
+
+using decoder_type = decoder_wrapper;
 }
 }
 }
@@ -0,0 +1,281 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "depacketizer.hpp"
+#include "packet.hpp"
+
+#include "decoder.hpp"
+#include "generator/random_uniform.hpp"
+
+#include "../buffer.hpp"
+#include "../version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <kodo/perpetual/width.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace perpetual
+{
+namespace
+{
+struct depacketizer_type
+{
+    depacketizer_type(double mapping_threshold,
+                      pybind11::object max_block_bytes) :
+        m_mapping_threshold(mapping_threshold)
+    {
+        if (!max_block_bytes.is_none())
+        {
+            m_max_block_bytes = max_block_bytes.cast<std::size_t>();
+            if (m_max_block_bytes == 0)
+            {
+                throw pybind11::value_error(
+                    "max_block_bytes: must be greater than zero");
+            }
+        }
+    }
+
+    /// @return True if the decoder is configured as described by the header
+    bool is_configured_for(const packet::header& header) const
+    {
+        return m_decoder && m_header.width == header.width &&
+               m_header.block_bytes == header.block_bytes &&
+               m_header.symbol_bytes == header.symbol_bytes &&
+               m_header.outer_interval == header.outer_interval &&
+               m_header.outer_segments == header.outer_segments;
+    }
+
+    double m_mapping_threshold;
+
+    /// The largest block accepted from a packet header, zero for no limit
+    std::size_t m_max_block_bytes = 0;
+
+    std::unique_ptr<decoder_type> m_decoder;
+    std::unique_ptr<generator::random_uniform_type> m_generator;
+
+    /// The header of the packets the decoder is configured for
+    packet::header m_header;
+
+    /// The decoded block, the decoder's symbol storage
+    pybind11::object m_data = pybind11::none();
+
+    /// Scratch copy of the symbol, the decoder decodes in place
+    std::vector<uint8_t> m_symbol;
+};
+
+bool depacketizer_is_width(uint8_t value)
+{
+    using kodo::perpetual::width;
+    for (auto w : {width::_8, width::_16, width::_32, width::_64})
+    {
+        if (value == static_cast<uint8_t>(w))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void depacketizer_configure(depacketizer_type& depacketizer,
+                            const packet::header& header)
+{
+    auto width = static_cast<kodo::perpetual::width>(header.width);
+
+    auto decoder = std::make_unique<decoder_type>(width);
+    decoder->configure(header.block_bytes, header.symbol_bytes,
+                       header.outer_interval, header.outer_segments,
+                       depacketizer.m_mapping_threshold);
+
+    pybind11::object data = make_bytearray(decoder->block_bytes());
+    buffer_view storage(data, true, "data");
+    std::memset(storage.data(), 0, storage.size());
+
+    decoder->set_symbols_storage(storage.data());
+    decoder->m_storage = std::move(storage);
+
+    depacketizer.m_decoder = std::move(decoder);
+    depacketizer.m_generator =
+        std::make_unique<generator::random_uniform_type>(width);
+    depacketizer.m_header = header;
+    depacketizer.m_data = data;
+    depacketizer.m_symbol.resize(header.symbol_bytes);
+}
+
+void depacketizer_reset(depacketizer_type& depacketizer)
+{
+    depacketizer.m_decoder.reset();
+    depacketizer.m_generator.reset();
+    depacketizer.m_data = pybind11::none();
+}
+
+/// Check the header of a packet from the network before it is used to
+/// configure a decoder
+void depacketizer_check_header(const depacketizer_type& depacketizer,
+                               const packet::header& header,
+                               std::size_t packet_bytes)
+{
+    if (!depacketizer_is_width(header.width))
+    {
+        throw pybind11::value_error("packet: invalid width");
+    }
+    if (header.block_bytes == 0 || header.symbol_bytes == 0)
+    {
+        throw pybind11::value_error("packet: invalid block or symbol size");
+    }
+    if (header.symbol_bytes > header.block_bytes)
+    {
+        throw pybind11::value_error(
+            "packet: symbol_bytes must not be greater than block_bytes");
+    }
+    if (depacketizer.m_max_block_bytes != 0 &&
+        header.block_bytes > depacketizer.m_max_block_bytes)
+    {
+        throw pybind11::value_error(
+            "packet: block_bytes greater than max_block_bytes");
+    }
+    if (header.outer_interval != 0 && header.outer_segments == 0)
+    {
+        throw pybind11::value_error(
+            "packet: outer_segments must be greater than zero when "
+            "outer_interval is");
+    }
+    if (packet_bytes < packet::header_bytes + header.symbol_bytes)
+    {
+        throw pybind11::value_error("packet: shorter than symbol_bytes");
+    }
+}
+
+bool depacketizer_decode_packet(depacketizer_type& depacketizer,
+                                pybind11::buffer packet)
+{
+    buffer_view packet_view(packet, false, "packet");
+
+    if (packet_view.size() < packet::header_bytes)
+    {
+        throw pybind11::value_error("packet: shorter than the header");
+    }
+
+    auto header = packet::read_header(packet_view.data());
+
+    // The first packet configures the decoder. Packets of another block
+    // are rejected until reset() is called
+    if (!depacketizer.m_decoder)
+    {
+        depacketizer_check_header(depacketizer, header, packet_view.size());
+        depacketizer_configure(depacketizer, header);
+    }
+    else if (!depacketizer.is_configured_for(header))
+    {
+        throw pybind11::value_error(
+            "packet: header does not match the block being decoded");
+    }
+    else if (packet_view.size() < packet::header_bytes + header.symbol_bytes)
+    {
+        throw pybind11::value_error("packet: shorter than symbol_bytes");
+    }
+
+    auto& decoder = *depacketizer.m_decoder;
+
+    if (header.offset >= decoder.symbols())
+    {
+        throw pybind11::value_error("packet: offset must be less than symbols");
+    }
+
+    if (decoder.is_complete())
+    {
+        return false;
+    }
+
+    auto rank = decoder.rank();
+    {
+        pybind11::gil_scoped_release release;
+
+        std::memcpy(depacketizer.m_symbol.data(),
+                    packet::symbol(packet_view.data()), header.symbol_bytes);
+        auto coefficients = depacketizer.m_generator->generate(header.seed);
+        decoder.decode_symbol_with_stats(depacketizer.m_symbol.data(),
+                                         coefficients, header.offset);
+    }
+    return decoder.rank() != rank;
+}
+}
+
+void depacketizer(pybind11::module& m)
+{
+    using namespace pybind11;
+    class_<depacketizer_type>(
+        m, "Depacketizer",
+        "Decodes the packets written by a Packetizer. The decoder is "
+        "configured from the header of the first packet. Packets with "
+        "other parameters are rejected until reset() is called.\n")
+        .def(init<double, object>(), arg("mapping_threshold") = 0.98,
+             arg("max_block_bytes") = none(),
+             "The Depacketizer constructor.\n\n"
+             "\t:param mapping_threshold: The ratio of inner symbols "
+             "received at which the inner code maps to the outer code.\n"
+             "\t:param max_block_bytes: The largest block accepted from a "
+             "packet header, None for no limit.\n")
+        .def("decode_packet", &depacketizer_decode_packet, arg("packet"),
+             "Decodes a packet, e.g. a datagram as received. Return True if "
+             "the packet increased the rank of the decoder. Raise ValueError "
+             "if the packet is malformed or belongs to another block.\n\n"
+             "\t:param packet: The packet, including the header.\n")
+        .def("reset", &depacketizer_reset,
+             "Drops the decoder and the decoded data, the next packet "
+             "configures a new decoder, e.g. for the next block.\n")
+        .def(
+            "is_complete",
+            [](const depacketizer_type& d)
+            { return d.m_decoder && d.m_decoder->is_complete(); },
+            "Return True if the block is decoded.\n")
+        .def_property_readonly(
+            "rank",
+            [](const depacketizer_type& d) -> std::size_t
+            { return d.m_decoder ? d.m_decoder->rank() : 0; },
+            "Return the rank of the decoder.\n")
+        .def_property_readonly(
+            "symbols",
+            [](const depacketizer_type& d) -> std::size_t
+            { return d.m_decoder ? d.m_decoder->symbols() : 0; },
+            "Return the total number of symbols of the decoder, zero before "
+            "the first packet.\n")
+        .def_property_readonly(
+            "block_bytes",
+            [](const depacketizer_type& d) -> std::size_t
+            { return d.m_decoder ? d.m_decoder->block_bytes() : 0; },
+            "Return the size of the block in bytes, zero before the first "
+            "packet.\n")
+        .def_property_readonly(
+            "data", [](const depacketizer_type& d) { return d.m_data; },
+            "Return the bytearray the block is decoded into, or None before "
+            "the first packet. It is complete when is_complete() is True.\n");
+}
+}
+}
+}
@@ -20,13 +20,20 @@
 
 #include "encoder.hpp"
 
+#include "generator/random_uniform.hpp"
+#include "offset/random_uniform.hpp"
+
+#include "../buffer.hpp"
+#include "../thread_pool.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
 
 #include <kodo/perpetual/encoder.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -37,21 +44,6 @@ inline namespace STEINWURF_KODO_PYTHON_VERSION
 {
 namespace perpetual
 {
-
-struct encoder_wrapper : kodo::perpetual::encoder
-{
-    encoder_wrapper(kodo::perpetual::width width) :
-        kodo::perpetual::encoder(width)
-    {
-    }
-    encoder_wrapper() : kodo::perpetual::encoder()
-    {
-    }
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using encoder_type = encoder_wrapper;
-
 void perpetual_encoder_enable_log(
     encoder_type& encoder,
     std::function<void(const std::string&, const std::string&)> callback)
@@ -60,6 +52,7 @@ void perpetual_encoder_enable_log(
     encoder.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             encoder_type* encoder = static_cast<encoder_type*>(data);
             assert(encoder->m_log_callback);
             encoder->m_log_callback(name, message);
@@ -67,11 +60,30 @@ void perpetual_encoder_enable_log(
         &encoder);
 }
 
+void perpetual_encoder_configure(encoder_type& encoder,
+                                 std::size_t block_bytes,
+                                 std::size_t symbol_bytes,
+                                 std::size_t outer_interval,
+                                 std::size_t outer_segments)
+{
+    encoder.configure(block_bytes, symbol_bytes, outer_interval,
+                      outer_segments);
+    encoder.m_storage = buffer_view();
+}
+
 void perpetual_encoder_set_symbols_storage(encoder_type& encoder,
-                                           pybind11::bytearray symbols_storage)
+                                           pybind11::buffer symbols_storage)
 {
-    encoder.set_symbols_storage(
-        (uint8_t*)PyByteArray_AsString(symbols_storage.ptr()));
+    buffer_view storage(symbols_storage, false, "symbols_storage");
+
+    if (storage.size() < encoder.block_bytes())
+    {
+        throw pybind11::value_error(
+            "symbols_storage: not large enough to contain block_bytes");
+    }
+
+    encoder.set_symbols_storage(storage.data());
+    encoder.m_storage = std::move(storage);
 }
 
 auto perpetual_encoder_encode_symbol(encoder_type& encoder,
@@ -85,12 +97,140 @@ auto perpetual_encoder_encode_symbol(encoder_type& encoder,
     }
 
     std::vector<uint8_t> symbol(encoder.symbol_bytes());
-
-    encoder.encode_symbol(symbol.data(), coefficients, offset);
+    {
+        pybind11::gil_scoped_release release;
+        encoder.encode_symbol(symbol.data(), coefficients, offset);
+    }
 
     return pybind11::bytearray{(char*)symbol.data(), symbol.size()};
 }
 
+auto perpetual_encoder_encode_symbols(
+    encoder_type& encoder, generator::random_uniform_type& generator,
+    offset::random_uniform_type& offset_generator,
+    pybind11::sequence seeds_sequence, pybind11::object symbols_out)
+    -> pybind11::tuple
+{
+    if (generator.width() != encoder.width())
+    {
+        throw pybind11::value_error(
+            "generator: must have the same width as the encoder");
+    }
+    if (offset_generator.symbols() != encoder.symbols())
+    {
+        throw pybind11::value_error(
+            "offset_generator: must be configured with Encoder.symbols");
+    }
+
+    std::vector<uint64_t> seeds;
+    seeds.reserve(seeds_sequence.size());
+    for (auto seed : seeds_sequence)
+    {
+        seeds.push_back(seed.cast<uint64_t>());
+    }
+
+    auto symbol_bytes = encoder.symbol_bytes();
+    auto count = seeds.size();
+
+    if (symbols_out.is_none())
+    {
+        symbols_out = make_bytearray(count * symbol_bytes);
+    }
+
+    buffer_view symbols_view(symbols_out, true, "symbols");
+
+    if (symbols_view.size() < count * symbol_bytes)
+    {
+        throw pybind11::value_error(
+            "symbols: not large enough to contain a symbol for each seed");
+    }
+
+    std::vector<std::size_t> offsets(count);
+    {
+        pybind11::gil_scoped_release release;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            offsets[i] = offset_generator.offset();
+            auto coefficients = generator.generate(seeds[i]);
+            encoder.encode_symbol(symbols_view.data() + i * symbol_bytes,
+                                  coefficients, offsets[i]);
+        }
+    }
+
+    pybind11::list offsets_list;
+    for (auto offset : offsets)
+    {
+        offsets_list.append(offset);
+    }
+    return pybind11::make_tuple(symbols_out, offsets_list);
+}
+
+auto perpetual_encoder_prepare(encoder_type& encoder, std::size_t threads)
+    -> pybind11::dict
+{
+    if (encoder.m_storage.data() == nullptr)
+    {
+        throw pybind11::value_error(
+            "symbols_storage: must be set before prepare");
+    }
+
+    using clock = std::chrono::steady_clock;
+
+    std::size_t pool_threads;
+    clock::time_point start;
+    clock::time_point prefaulted;
+    clock::time_point prepared;
+    {
+        pybind11::gil_scoped_release release;
+
+        start = clock::now();
+
+        // Fault in the pages of the storage, e.g. a memory mapped file,
+        // from all threads so the encoder does not stall on them
+        thread_pool pool(threads);
+        pool_threads = pool.threads();
+
+        const std::size_t page_bytes = 4096;
+        const volatile uint8_t* data = encoder.m_storage.data();
+        std::size_t pages =
+            (encoder.block_bytes() + page_bytes - 1) / page_bytes;
+        std::size_t chunk = (pages + pool_threads - 1) / pool_threads;
+
+        pool.parallel_for(
+            pool_threads,
+            [&](std::size_t thread)
+            {
+                std::size_t end = std::min(pages, (thread + 1) * chunk);
+                for (std::size_t page = thread * chunk; page < end; ++page)
+                {
+                    (void)data[page * page_bytes];
+                }
+            });
+
+        prefaulted = clock::now();
+
+        // The outer code symbols are computed on first use, so touch every
+        // symbol once
+        std::vector<uint8_t> symbol(encoder.symbol_bytes());
+        for (std::size_t offset = 0; offset < encoder.symbols(); ++offset)
+        {
+            encoder.encode_symbol(symbol.data(), 1U, offset);
+        }
+
+        prepared = clock::now();
+    }
+
+    using seconds = std::chrono::duration<double>;
+
+    pybind11::dict timings;
+    timings["threads"] = pool_threads;
+    timings["prefault"] = seconds(prefaulted - start).count();
+    timings["outer_symbols"] = seconds(prepared - prefaulted).count();
+    timings["total"] = seconds(prepared - start).count();
+    return timings;
+}
+
 void encoder(pybind11::module& m)
 {
     using namespace pybind11;
@@ -98,7 +238,7 @@ void encoder(pybind11::module& m)
         .def(init<kodo::perpetual::width>(), arg("width"),
              "The perpetual encoder constructor\n\n"
              "\t:param width: the chosen coding width.\n")
-        .def("configure", &encoder_type::configure, arg("block_bytes"),
+        .def("configure", &perpetual_encoder_configure, arg("block_bytes"),
              arg("symbol_bytes"), arg("outer_interval") = 8,
              arg("outer_segments") = 8,
              "configure the encoder with the given parameters. This is also "
@@ -148,11 +288,40 @@ void encoder(pybind11::module& m)
                                "encoded with this encoder.\n")
         .def("set_symbols_storage", &perpetual_encoder_set_symbols_storage,
              arg("symbols_storage"),
-             "Initialize all the symbols in the block.\n\n"
+             "Initialize all the symbols in the block. The buffer is kept "
+             "exported, i.e. it cannot be resized, until the encoder is "
+             "reconfigured or destroyed.\n\n"
              "\t:param symbols_storage: The buffer containing all the data for "
-             "the block.\n")
+             "the block. Any object supporting the buffer protocol can be "
+             "used e.g. bytes, bytearray, mmap or a numpy array.\n")
         .def("symbols_storage", &encoder_type::symbols_storage,
              "Return the memory of the block.\n")
+        .def("prepare", &perpetual_encoder_prepare, arg("threads") = 0,
+             "Does the one-off work of the encoder up front instead of in "
+             "the first encode calls. The pages of the symbol storage are "
+             "faulted in on multiple threads and the outer code symbols are "
+             "computed. Call it after set_symbols_storage().\n\n"
+             "Return a dict with the number of threads used and the time in "
+             "seconds spent in the \"prefault\" and \"outer_symbols\" "
+             "phases and in \"total\".\n"
+             "\t:param threads: The number of threads to use, zero selects "
+             "the number of hardware threads.\n")
+        .def("encode_symbols", &perpetual_encoder_encode_symbols,
+             arg("generator"), arg("offset_generator"), arg("seeds"),
+             arg("symbols") = none(),
+             "Encodes a symbol for each seed into one contiguous buffer. This "
+             "is the same as calling offset_generator.offset(), "
+             "generator.generate() and encode_symbol() for each seed, but in "
+             "a single call without the GIL.\n\n"
+             "\t:param generator: A generator.RandomUniform with the width "
+             "of the encoder.\n"
+             "\t:param offset_generator: An offset.RandomUniform configured "
+             "with Encoder.symbols.\n"
+             "\t:param seeds: A sequence with the seed of each symbol.\n"
+             "\t:param symbols: A writable buffer of at least "
+             "len(seeds) * symbol_bytes bytes, or None to allocate one.\n"
+             "Return a tuple of the symbols buffer and a list with the "
+             "offset used for each symbol.\n")
         .def("encode_symbol", &perpetual_encoder_encode_symbol,
              arg("coefficients"), arg("offset"),
              "Creates a new encoded symbol given the passed encoding "
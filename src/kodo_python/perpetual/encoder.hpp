@@ -20,10 +20,18 @@
 
 #pragma once
 
+#include "../buffer.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
 
+#include <kodo/perpetual/encoder.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
 namespace kodo_python
 {
 inline namespace STEINWURF_KODO_PYTHON_VERSION
@@ -31,6 +39,23 @@ inline namespace STEINWURF_KODO_PYTHON_VERSION
 namespace perpetual
 {
 void encoder(pybind11::module& m);
+
+struct encoder_wrapper : kodo::perpetual::encoder
+{
+    encoder_wrapper(kodo::perpetual::width width) :
+        kodo::perpetual::encoder(width)
+    {
+    }
+    encoder_wrapper() : kodo::perpetual::encoder()
+    {
+    }
+    std::function<void(const std::string&, const std::string&)> m_log_callback;
+
+    /// Buffer export pinning the memory given as symbol storage
+    buffer_view m_storage;
+};
+
+using encoder_type = encoder_wrapper;
 }
 }
 }
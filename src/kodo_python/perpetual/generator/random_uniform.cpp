@@ -20,6 +20,7 @@
 
 #include "random_uniform.hpp"
 
+#include "../../buffer.hpp"
 #include "../../version.hpp"
 
 #include <pybind11/pybind11.h>
@@ -28,6 +29,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <string>
 #include <vector>
@@ -40,17 +42,6 @@ namespace perpetual
 {
 namespace generator
 {
-struct random_uniform_wrapper : kodo::perpetual::generator::random_uniform
-{
-    random_uniform_wrapper(kodo::perpetual::width width) :
-        kodo::perpetual::generator::random_uniform(width)
-    {
-    }
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using random_uniform_type = random_uniform_wrapper;
-
 void generator_random_uniform_enable_log(
     random_uniform_type& generator,
     std::function<void(const std::string&, const std::string&)> callback)
@@ -59,6 +50,7 @@ void generator_random_uniform_enable_log(
     generator.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             random_uniform_type* generator =
                 static_cast<random_uniform_type*>(data);
             assert(generator->m_log_callback);
@@ -67,6 +59,67 @@ void generator_random_uniform_enable_log(
         &generator);
 }
 
+auto generator_random_uniform_generate_many(random_uniform_type& generator,
+                                            pybind11::object seeds_object,
+                                            pybind11::object out)
+    -> pybind11::object
+{
+    std::vector<uint64_t> seeds;
+
+    if (PyObject_CheckBuffer(seeds_object.ptr()))
+    {
+        buffer_view seeds_view(seeds_object, false, "seeds");
+        if (!seeds_view.is_int64())
+        {
+            throw pybind11::value_error(
+                "seeds: must contain 64 bit unsigned integers");
+        }
+        seeds.resize(seeds_view.size() / sizeof(uint64_t));
+        std::memcpy(seeds.data(), seeds_view.data(), seeds_view.size());
+    }
+    else
+    {
+        for (auto seed : pybind11::reinterpret_borrow<pybind11::iterable>(
+                 seeds_object))
+        {
+            seeds.push_back(seed.cast<uint64_t>());
+        }
+    }
+
+    if (out.is_none())
+    {
+        out = make_uint64_array(seeds.size());
+    }
+
+    buffer_view out_view(out, true, "out");
+
+    if (!out_view.is_int64())
+    {
+        throw pybind11::value_error(
+            "out: must contain 64 bit unsigned integers");
+    }
+
+    if (out_view.size() < seeds.size() * sizeof(uint64_t))
+    {
+        throw pybind11::value_error(
+            "out: not large enough to contain the coefficients of each seed");
+    }
+
+    {
+        pybind11::gil_scoped_release release;
+
+        uint8_t* data = out_view.data();
+        for (std::size_t i = 0; i < seeds.size(); ++i)
+        {
+            uint64_t coefficients = generator.generate(seeds[i]);
+            std::memcpy(data + i * sizeof(uint64_t), &coefficients,
+                        sizeof(uint64_t));
+        }
+    }
+
+    return out;
+}
+
 void random_uniform(pybind11::module m)
 {
     using namespace pybind11;
@@ -79,10 +132,22 @@ void random_uniform(pybind11::module m)
             "width", &random_uniform_type::width,
             "Return the width of the generator in symbols.\n")
         .def("generate", &random_uniform_type::generate, arg("seed"),
+             call_guard<gil_scoped_release>(),
              "Generates the coefficients.\n\n"
              "Return the generated coefficients as an integer"
              "where each bit represents a coefficient.\n"
              "\t:param seed: The seed for the generator.\n")
+        .def("generate_many", &generator_random_uniform_generate_many,
+             arg("seeds"), arg("out") = none(),
+             "Generates the coefficients of each seed, the same as calling "
+             "generate() for each seed.\n\n"
+             "Return the buffer with the coefficients as native 64 bit "
+             "unsigned integers.\n"
+             "\t:param seeds: A sequence of seeds, or a buffer of native 64 "
+             "bit unsigned integers such as an array.array(\"Q\").\n"
+             "\t:param out: A writable buffer for len(seeds) native 64 bit "
+             "unsigned integers. If None a new array.array(\"Q\") is "
+             "returned.\n")
         .def(
             "enable_log", &generator_random_uniform_enable_log, arg("callback"),
             "Enable logging for this generator.\n\n"
@@ -24,6 +24,11 @@
 
 #include <pybind11/pybind11.h>
 
+#include <kodo/perpetual/generator/random_uniform.hpp>
+
+#include <functional>
+#include <string>
+
 namespace kodo_python
 {
 inline namespace STEINWURF_KODO_PYTHON_VERSION
@@ -33,6 +38,17 @@ namespace perpetual
 namespace generator
 {
 void random_uniform(pybind11::module m);
+
+struct random_uniform_wrapper : kodo::perpetual::generator::random_uniform
+{
+    random_uniform_wrapper(kodo::perpetual::width width) :
+        kodo::perpetual::generator::random_uniform(width)
+    {
+    }
+    std::function<void(const std::string&, const std::string&)> m_log_callback;
+};
+
+using random_uniform_type = random_uniform_wrapper;
 }
 }
 }
@@ -20,6 +20,7 @@
 
 #include "random_uniform.hpp"
 
+#include "../../buffer.hpp"
 #include "../../version.hpp"
 
 #include <pybind11/pybind11.h>
@@ -28,6 +29,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <string>
 #include <vector>
@@ -40,13 +42,6 @@ namespace perpetual
 {
 namespace offset
 {
-struct random_uniform_wrapper : kodo::perpetual::offset::random_uniform
-{
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using random_uniform_type = random_uniform_wrapper;
-
 void offset_random_uniform_enable_log(
     random_uniform_type& offset_generator,
     std::function<void(const std::string&, const std::string&)> callback)
@@ -55,6 +50,7 @@ void offset_random_uniform_enable_log(
     offset_generator.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             random_uniform_type* offset_generator =
                 static_cast<random_uniform_type*>(data);
             assert(offset_generator->m_log_callback);
@@ -63,6 +59,49 @@ void offset_random_uniform_enable_log(
         &offset_generator);
 }
 
+auto offset_random_uniform_offsets(random_uniform_type& offset_generator,
+                                   std::size_t count, pybind11::object out)
+    -> pybind11::object
+{
+    if (offset_generator.symbols() == 0)
+    {
+        throw pybind11::value_error("symbols: the generator is not configured");
+    }
+
+    if (out.is_none())
+    {
+        out = make_uint64_array(count);
+    }
+
+    buffer_view out_view(out, true, "out");
+
+    if (!out_view.is_int64())
+    {
+        throw pybind11::value_error(
+            "out: must contain 64 bit unsigned integers");
+    }
+
+    if (out_view.size() < count * sizeof(uint64_t))
+    {
+        throw pybind11::value_error(
+            "out: not large enough to contain count 64 bit offsets");
+    }
+
+    {
+        pybind11::gil_scoped_release release;
+
+        uint8_t* data = out_view.data();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            uint64_t offset = offset_generator.offset();
+            std::memcpy(data + i * sizeof(uint64_t), &offset,
+                        sizeof(uint64_t));
+        }
+    }
+
+    return out;
+}
+
 void random_uniform(pybind11::module m)
 {
     using namespace pybind11;
@@ -81,6 +120,15 @@ void random_uniform(pybind11::module m)
             "Return the number of symbols supported by this generator.\n")
         .def("offset", &random_uniform_type::offset,
              "Return the next offset.\n")
+        .def("offsets", &offset_random_uniform_offsets, arg("count"),
+             arg("out") = none(),
+             "Return the next count offsets, the same as calling offset() "
+             "count times.\n\n"
+             "\t:param count: The number of offsets.\n"
+             "\t:param out: A writable buffer for count native 64 bit "
+             "unsigned integers, e.g. an array.array(\"Q\") or a numpy "
+             "uint64 array. If None a new array.array(\"Q\") is "
+             "returned.\n")
         .def("set_seed", &random_uniform_type::set_seed, arg("seed"),
              "Set the seed for the offset generator.\n\n"
              "\t:param seed: The chosen seed.\n")
@@ -24,6 +24,11 @@
 
 #include <pybind11/pybind11.h>
 
+#include <kodo/perpetual/offset/random_uniform.hpp>
+
+#include <functional>
+#include <string>
+
 namespace kodo_python
 {
 inline namespace STEINWURF_KODO_PYTHON_VERSION
@@ -33,6 +38,13 @@ namespace perpetual
 namespace offset
 {
 void random_uniform(pybind11::module m);
+
+struct random_uniform_wrapper : kodo::perpetual::offset::random_uniform
+{
+    std::function<void(const std::string&, const std::string&)> m_log_callback;
+};
+
+using random_uniform_type = random_uniform_wrapper;
 }
 }
 }
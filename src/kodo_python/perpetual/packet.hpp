@@ -0,0 +1,127 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstdint>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace perpetual
+{
+/// The packets of the Packetizer and Depacketizer are laid out as:
+///
+///   u64 seed | u64 offset | u8 width | u32 block_bytes | u32 symbol_bytes |
+///   u8 outer_interval | u8 outer_segments | symbol
+///
+/// with little endian integers, i.e. the header is the struct format
+/// "<QQBIIBB". The header carries everything the receiver needs to
+/// configure its decoder.
+namespace packet
+{
+/// The size of the header in bytes
+static const std::size_t header_bytes = 27;
+
+struct header
+{
+    uint64_t seed;
+    uint64_t offset;
+    uint8_t width;
+    uint32_t block_bytes;
+    uint32_t symbol_bytes;
+    uint8_t outer_interval;
+    uint8_t outer_segments;
+};
+
+inline void write_u64(uint8_t* data, uint64_t value)
+{
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline uint64_t read_u64(const uint8_t* data)
+{
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+inline void write_u32(uint8_t* data, uint32_t value)
+{
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+    data[2] = static_cast<uint8_t>(value >> 16);
+    data[3] = static_cast<uint8_t>(value >> 24);
+}
+
+inline uint32_t read_u32(const uint8_t* data)
+{
+    return static_cast<uint32_t>(data[0]) |
+           static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 |
+           static_cast<uint32_t>(data[3]) << 24;
+}
+
+inline void write_header(uint8_t* packet, const header& fields)
+{
+    write_u64(packet, fields.seed);
+    write_u64(packet + 8, fields.offset);
+    packet[16] = fields.width;
+    write_u32(packet + 17, fields.block_bytes);
+    write_u32(packet + 21, fields.symbol_bytes);
+    packet[25] = fields.outer_interval;
+    packet[26] = fields.outer_segments;
+}
+
+inline header read_header(const uint8_t* packet)
+{
+    header fields;
+    fields.seed = read_u64(packet);
+    fields.offset = read_u64(packet + 8);
+    fields.width = packet[16];
+    fields.block_bytes = read_u32(packet + 17);
+    fields.symbol_bytes = read_u32(packet + 21);
+    fields.outer_interval = packet[25];
+    fields.outer_segments = packet[26];
+    return fields;
+}
+
+inline uint8_t* symbol(uint8_t* packet)
+{
+    return packet + header_bytes;
+}
+
+inline const uint8_t* symbol(const uint8_t* packet)
+{
+    return packet + header_bytes;
+}
+}
+}
+}
+}
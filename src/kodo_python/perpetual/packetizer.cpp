@@ -0,0 +1,232 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "packetizer.hpp"
+#include "packet.hpp"
+
+#include "encoder.hpp"
+#include "generator/random_uniform.hpp"
+#include "offset/random_uniform.hpp"
+
+#include "../buffer.hpp"
+#include "../version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <kodo/perpetual/width.hpp>
+
+#include <cstdint>
+#include <random>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace perpetual
+{
+namespace
+{
+struct packetizer_type
+{
+    packetizer_type(kodo::perpetual::width width, std::size_t block_bytes,
+                    std::size_t symbol_bytes, std::size_t outer_interval,
+                    std::size_t outer_segments) :
+        m_encoder(width),
+        m_generator(width)
+    {
+        if (block_bytes == 0 || block_bytes > UINT32_MAX)
+        {
+            throw pybind11::value_error(
+                "block_bytes: must be greater than zero and fit in 32 bits");
+        }
+        if (symbol_bytes == 0 || symbol_bytes > UINT32_MAX)
+        {
+            throw pybind11::value_error(
+                "symbol_bytes: must be greater than zero and fit in 32 bits");
+        }
+        if (symbol_bytes > block_bytes)
+        {
+            throw pybind11::value_error(
+                "symbol_bytes: must not be greater than block_bytes");
+        }
+        if (outer_interval != 0 && outer_segments == 0)
+        {
+            throw pybind11::value_error(
+                "outer_segments: must be greater than zero when "
+                "outer_interval is");
+        }
+        if (outer_interval > UINT8_MAX || outer_segments > UINT8_MAX)
+        {
+            throw pybind11::value_error(
+                "outer_interval: outer_interval and outer_segments must fit "
+                "in 8 bits");
+        }
+
+        m_encoder.configure(block_bytes, symbol_bytes, outer_interval,
+                            outer_segments);
+        m_offset_generator.configure(m_encoder.symbols());
+
+        m_header.width = static_cast<uint8_t>(width);
+        m_header.block_bytes = static_cast<uint32_t>(block_bytes);
+        m_header.symbol_bytes = static_cast<uint32_t>(symbol_bytes);
+        m_header.outer_interval = static_cast<uint8_t>(outer_interval);
+        m_header.outer_segments = static_cast<uint8_t>(outer_segments);
+
+        // Different packetizers of the same data use different seeds
+        std::random_device random;
+        m_random.seed((uint64_t)random() << 32 | random());
+    }
+
+    auto packet_bytes() const -> std::size_t
+    {
+        return packet::header_bytes + m_encoder.symbol_bytes();
+    }
+
+    encoder_type m_encoder;
+    generator::random_uniform_type m_generator;
+    offset::random_uniform_type m_offset_generator;
+
+    /// The header fields which are the same for all packets
+    packet::header m_header;
+
+    /// Draws the seeds of packets written without a seed
+    std::mt19937_64 m_random;
+};
+
+void packetizer_set_symbols_storage(packetizer_type& packetizer,
+                                    pybind11::buffer symbols_storage)
+{
+    buffer_view storage(symbols_storage, false, "symbols_storage");
+
+    if (storage.size() < packetizer.m_encoder.block_bytes())
+    {
+        throw pybind11::value_error(
+            "symbols_storage: not large enough to contain block_bytes");
+    }
+
+    packetizer.m_encoder.set_symbols_storage(storage.data());
+    packetizer.m_encoder.m_storage = std::move(storage);
+}
+
+auto packetizer_write_packet(packetizer_type& packetizer,
+                             pybind11::object packet, pybind11::object seed)
+    -> pybind11::object
+{
+    if (packetizer.m_encoder.m_storage.data() == nullptr)
+    {
+        throw pybind11::value_error(
+            "symbols_storage: must be set before writing packets");
+    }
+
+    auto packet_bytes = packetizer.packet_bytes();
+
+    if (packet.is_none())
+    {
+        packet = make_bytearray(packet_bytes);
+    }
+
+    buffer_view packet_view(packet, true, "packet");
+
+    if (packet_view.size() < packet_bytes)
+    {
+        throw pybind11::value_error(
+            "packet: not large enough to contain packet_bytes");
+    }
+
+    packet::header header = packetizer.m_header;
+    header.seed =
+        seed.is_none() ? packetizer.m_random() : seed.cast<uint64_t>();
+
+    {
+        pybind11::gil_scoped_release release;
+
+        header.offset = packetizer.m_offset_generator.offset();
+        auto coefficients = packetizer.m_generator.generate(header.seed);
+
+        packet::write_header(packet_view.data(), header);
+        packetizer.m_encoder.encode_symbol(packet::symbol(packet_view.data()),
+                                           coefficients, header.offset);
+    }
+
+    return packet;
+}
+}
+
+void packetizer(pybind11::module& m)
+{
+    using namespace pybind11;
+    class_<packetizer_type>(
+        m, "Packetizer",
+        "Encodes a block with the perpetual code into complete packets "
+        "ready to send, see Depacketizer for the receiving side.\n\n"
+        "Packets are laid out as the header struct \"<QQBIIBB\" with the "
+        "seed, offset, width, block_bytes, symbol_bytes, outer_interval and "
+        "outer_segments, followed by symbol_bytes symbol data.\n")
+        .def(init<kodo::perpetual::width, std::size_t, std::size_t,
+                  std::size_t, std::size_t>(),
+             arg("width"), arg("block_bytes"), arg("symbol_bytes"),
+             arg("outer_interval") = 8, arg("outer_segments") = 8,
+             "The Packetizer constructor.\n\n"
+             "\t:param width: The coding width.\n"
+             "\t:param block_bytes: The size of the block in bytes.\n"
+             "\t:param symbol_bytes: The size of a symbol in bytes.\n"
+             "\t:param outer_interval: The number of inner code symbols "
+             "between two outer code symbols.\n"
+             "\t:param outer_segments: The number of width segments to code "
+             "outer symbols by.\n")
+        .def("set_symbols_storage", &packetizer_set_symbols_storage,
+             arg("symbols_storage"),
+             "Sets the data to encode. The buffer is kept exported while it "
+             "is in use.\n\n"
+             "\t:param symbols_storage: A buffer of at least block_bytes "
+             "bytes.\n")
+        .def("write_packet", &packetizer_write_packet,
+             arg("packet") = none(), arg("seed") = none(),
+             "Encodes a symbol and writes it with its header into a packet. "
+             "Return the packet.\n\n"
+             "\t:param packet: A writable buffer of at least packet_bytes "
+             "bytes, which can be reused for every packet, or None to "
+             "allocate one.\n"
+             "\t:param seed: The seed of the coding coefficients, or None to "
+             "draw a random seed.\n")
+        .def_property_readonly(
+            "width",
+            [](const packetizer_type& p) { return p.m_encoder.width(); },
+            "Return the coding width.\n")
+        .def_property_readonly(
+            "block_bytes",
+            [](const packetizer_type& p) { return p.m_encoder.block_bytes(); },
+            "Return the size of the block in bytes.\n")
+        .def_property_readonly(
+            "symbol_bytes",
+            [](const packetizer_type& p) { return p.m_encoder.symbol_bytes(); },
+            "Return the size of a symbol in bytes.\n")
+        .def_property_readonly(
+            "symbols",
+            [](const packetizer_type& p) { return p.m_encoder.symbols(); },
+            "Return the total number of symbols of the encoder.\n")
+        .def_property_readonly(
+            "packet_bytes",
+            [](const packetizer_type& p) { return p.packet_bytes(); },
+            "Return the size of a packet in bytes.\n");
+}
+}
+}
+}
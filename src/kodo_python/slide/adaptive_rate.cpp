@@ -0,0 +1,148 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "adaptive_rate.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+adaptive_rate::adaptive_rate(std::size_t min_window, std::size_t max_window,
+                             double max_repair_ratio, double smoothing,
+                             double margin, double initial_loss) :
+    m_min_window(min_window),
+    m_max_window(max_window),
+    m_max_repair_ratio(max_repair_ratio),
+    m_smoothing(smoothing),
+    m_margin(margin),
+    m_loss(initial_loss)
+{
+    assert(min_window > 0);
+    assert(min_window <= max_window);
+    assert(max_repair_ratio > 0.0);
+    assert(smoothing > 0.0 && smoothing <= 1.0);
+    assert(margin >= 0.0);
+    assert(initial_loss >= 0.0 && initial_loss <= 1.0);
+
+    update_repair_ratio();
+    update_window(0);
+}
+
+bool adaptive_rate::send_repair() const
+{
+    return m_credit >= 1.0;
+}
+
+void adaptive_rate::advance()
+{
+    if (send_repair())
+    {
+        m_credit -= 1.0;
+        ++m_repair_symbols;
+    }
+    else
+    {
+        m_credit += m_repair_ratio;
+        ++m_source_symbols;
+    }
+}
+
+void adaptive_rate::feedback(uint64_t decoded_upper_bound, double loss,
+                             std::size_t rank_gap)
+{
+    loss = std::min(std::max(loss, 0.0), 1.0);
+    m_loss += m_smoothing * (loss - m_loss);
+    update_repair_ratio();
+
+    uint64_t lag = 0;
+    if (m_source_symbols > decoded_upper_bound)
+    {
+        lag = m_source_symbols - decoded_upper_bound;
+    }
+    update_window(lag);
+
+    // Send repair symbols for what the receiver is missing right away,
+    // but do not let repeated reports of the same gap add up
+    double gap = static_cast<double>(std::min(rank_gap, m_window_symbols));
+    m_credit = std::max(m_credit, gap);
+}
+
+auto adaptive_rate::loss() const -> double
+{
+    return m_loss;
+}
+
+auto adaptive_rate::repair_ratio() const -> double
+{
+    return m_repair_ratio;
+}
+
+auto adaptive_rate::window_symbols() const -> std::size_t
+{
+    return m_window_symbols;
+}
+
+auto adaptive_rate::source_symbols() const -> uint64_t
+{
+    return m_source_symbols;
+}
+
+auto adaptive_rate::repair_symbols() const -> uint64_t
+{
+    return m_repair_symbols;
+}
+
+void adaptive_rate::update_repair_ratio()
+{
+    // With a loss of p, (sources + repairs) * (1 - p) >= sources requires
+    // p / (1 - p) repair symbols per source symbol
+    if (m_loss >= 1.0)
+    {
+        m_repair_ratio = m_max_repair_ratio;
+        return;
+    }
+
+    double ratio = m_loss / (1.0 - m_loss) * (1.0 + m_margin);
+    m_repair_ratio = std::min(ratio, m_max_repair_ratio);
+}
+
+void adaptive_rate::update_window(uint64_t lag)
+{
+    // Every source symbol should be covered by at least two repair symbols,
+    // and the window should reach back to what the receiver has decoded
+    double window = static_cast<double>(m_max_window);
+    if (m_repair_ratio > 0.0)
+    {
+        window = std::min(window, std::ceil(2.0 / m_repair_ratio));
+    }
+    window = std::max(window, static_cast<double>(lag));
+
+    m_window_symbols = std::min(
+        std::max(static_cast<std::size_t>(window), m_min_window), m_max_window);
+}
+}
+}
+}
@@ -0,0 +1,108 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+/// A rate controller which adjusts the number of repair symbols and the
+/// coding window to the loss reported by the receiver.
+///
+/// The loss is smoothed with an exponentially weighted moving average and
+/// the repair ratio, i.e. the number of repair symbols per source symbol,
+/// is set to cover the smoothed loss plus a margin. Repair symbols are
+/// spread evenly between the source symbols using a credit which grows by
+/// the repair ratio for every source symbol sent.
+class adaptive_rate
+{
+public:
+    /// @param min_window The smallest recommended window in symbols
+    /// @param max_window The largest recommended window in symbols
+    /// @param max_repair_ratio The largest number of repair symbols sent
+    ///        per source symbol
+    /// @param smoothing The weight of a new loss report in [0, 1]
+    /// @param margin The extra repair symbols sent relative to the loss
+    /// @param initial_loss The loss assumed until the first feedback
+    adaptive_rate(std::size_t min_window, std::size_t max_window,
+                  double max_repair_ratio, double smoothing, double margin,
+                  double initial_loss);
+
+    /// @return True if the next symbol should be a repair symbol
+    bool send_repair() const;
+
+    /// Move to the next symbol, call this after each symbol is sent
+    void advance();
+
+    /// Update the estimates with feedback from the receiver
+    ///
+    /// @param decoded_upper_bound One past the last symbol the receiver
+    ///        has decoded in order, counted in source symbols sent through
+    ///        this controller
+    /// @param loss The fraction of symbols lost since the last feedback
+    /// @param rank_gap The number of symbols the receiver is missing
+    void feedback(uint64_t decoded_upper_bound, double loss,
+                  std::size_t rank_gap);
+
+    /// @return The smoothed loss
+    auto loss() const -> double;
+
+    /// @return The number of repair symbols sent per source symbol
+    auto repair_ratio() const -> double;
+
+    /// @return The recommended number of symbols in the coding window
+    auto window_symbols() const -> std::size_t;
+
+    /// @return The number of source symbols sent
+    auto source_symbols() const -> uint64_t;
+
+    /// @return The number of repair symbols sent
+    auto repair_symbols() const -> uint64_t;
+
+private:
+    void update_repair_ratio();
+    void update_window(uint64_t lag);
+
+private:
+    std::size_t m_min_window;
+    std::size_t m_max_window;
+    double m_max_repair_ratio;
+    double m_smoothing;
+    double m_margin;
+
+    double m_loss;
+    double m_repair_ratio = 0.0;
+    double m_credit = 0.0;
+    std::size_t m_window_symbols = 0;
+
+    uint64_t m_source_symbols = 0;
+    uint64_t m_repair_symbols = 0;
+};
+}
+}
+}
@@ -0,0 +1,139 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "adaptive_rate_controller.hpp"
+#include "adaptive_rate.hpp"
+
+#include "../version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <cstdint>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+namespace
+{
+auto slide_adaptive_rate_controller_init(std::size_t min_window,
+                                         std::size_t max_window,
+                                         double max_repair_ratio,
+                                         double smoothing, double margin,
+                                         double initial_loss)
+    -> adaptive_rate*
+{
+    if (min_window == 0)
+    {
+        throw pybind11::value_error("min_window: must be greater than zero");
+    }
+    if (min_window > max_window)
+    {
+        throw pybind11::value_error(
+            "max_window: must be greater than or equal to min_window");
+    }
+    if (!(max_repair_ratio > 0.0))
+    {
+        throw pybind11::value_error(
+            "max_repair_ratio: must be greater than zero");
+    }
+    if (!(smoothing > 0.0 && smoothing <= 1.0))
+    {
+        throw pybind11::value_error("smoothing: must be in the range (0, 1]");
+    }
+    if (!(margin >= 0.0))
+    {
+        throw pybind11::value_error("margin: must not be negative");
+    }
+    if (!(initial_loss >= 0.0 && initial_loss <= 1.0))
+    {
+        throw pybind11::value_error(
+            "initial_loss: must be in the range [0, 1]");
+    }
+
+    return new adaptive_rate(min_window, max_window, max_repair_ratio,
+                             smoothing, margin, initial_loss);
+}
+}
+
+void adaptive_rate_controller(pybind11::module& m)
+{
+    using namespace pybind11;
+    class_<adaptive_rate>(m, "AdaptiveRateController",
+                          "A sliding window rate-controller which adjusts "
+                          "the repair ratio and window size to the loss "
+                          "reported by the receiver")
+        .def(init(&slide_adaptive_rate_controller_init),
+             arg("min_window") = 8, arg("max_window") = 64,
+             arg("max_repair_ratio") = 1.0, arg("smoothing") = 0.1,
+             arg("margin") = 0.5, arg("initial_loss") = 0.05,
+             "The AdaptiveRateController constructor.\n\n"
+             ":param min_window: The smallest recommended window in "
+             "symbols.\n"
+             ":param max_window: The largest recommended window in symbols.\n"
+             ":param max_repair_ratio: The largest number of repair symbols "
+             "sent per source symbol.\n"
+             ":param smoothing: The weight of a new loss report in the "
+             "moving average of the loss.\n"
+             ":param margin: The extra repair symbols sent relative to the "
+             "loss, e.g. 0.5 sends 50% more repair symbols than the loss "
+             "requires.\n"
+             ":param initial_loss: The loss assumed until the first "
+             "feedback.\n")
+        .def("advance", &adaptive_rate::advance,
+             "Move to the next symbol, call this after each symbol is "
+             "sent.\n")
+        .def("send_repair", &adaptive_rate::send_repair,
+             "If True, we should generate a repair symbol. Otherwise send a "
+             "source symbol.\n")
+        .def("feedback", &adaptive_rate::feedback,
+             arg("decoded_upper_bound"), arg("loss"), arg("rank_gap") = 0,
+             "Update the repair ratio and window size with feedback from the "
+             "receiver. This is cheap and can be called for every feedback "
+             "packet.\n\n"
+             ":param decoded_upper_bound: One past the last symbol the "
+             "receiver has decoded in order, counted in source symbols sent "
+             "through this controller.\n"
+             ":param loss: The fraction of symbols lost since the last "
+             "feedback.\n"
+             ":param rank_gap: The number of symbols the receiver is missing, "
+             "e.g. Decoder.symbols_missing. Repair symbols for these are "
+             "sent right away.\n")
+        .def_property_readonly("loss", &adaptive_rate::loss,
+                               "Return the moving average of the loss.\n")
+        .def_property_readonly("repair_ratio", &adaptive_rate::repair_ratio,
+                               "Return the number of repair symbols sent per "
+                               "source symbol.\n")
+        .def_property_readonly("window_symbols",
+                               &adaptive_rate::window_symbols,
+                               "Return the recommended number of symbols in "
+                               "the coding window.\n")
+        .def_property_readonly("source_symbols",
+                               &adaptive_rate::source_symbols,
+                               "Return the number of source symbols sent.\n")
+        .def_property_readonly("repair_symbols",
+                               &adaptive_rate::repair_symbols,
+                               "Return the number of repair symbols sent.\n");
+}
+}
+}
+}
@@ -19,8 +19,13 @@
 // See accompanying file LICENSE.rst or https://www.steinwurf.com/license
 
 #include "decoder.hpp"
+#include "feedback.hpp"
+#include "symbol_exports.hpp"
+#include "symbol_pool.hpp"
 #include "tuple_to_range.hpp"
 
+#include "../buffer.hpp"
+#include "../memory_view.hpp"
 #include "../version.hpp"
 
 #include <pybind11/functional.h>
@@ -29,9 +34,15 @@
 #include <kodo/slide/decoder.hpp>
 #include <kodo/slide/stream.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace kodo_python
@@ -53,6 +64,50 @@ struct decoder_wrapper : kodo::slide::decoder
 
     bool configured = false;
 
+    /// Buffers for the symbols handed to the decoder
+    std::shared_ptr<symbol_pool> m_pool = std::make_shared<symbol_pool>();
+
+    /// The symbols exported through memoryviews
+    std::shared_ptr<symbol_exports> m_exports =
+        std::make_shared<symbol_exports>();
+
+    /// The default capacity of advance_to, zero if not set
+    std::size_t m_capacity = 0;
+
+    /// The next symbol to deliver in order
+    uint64_t m_delivery_index = 0;
+
+    /// The number of symbols skipped by the in-order delivery
+    uint64_t m_skipped_symbols = 0;
+
+    /// Skip a hole when more symbols than this follow it, zero to disable
+    std::size_t m_max_gap = 0;
+
+    /// Skip holes after blocking delivery this long, zero to disable
+    std::chrono::steady_clock::duration m_max_hold{0};
+
+    /// Whether a hole is blocking delivery, since when and its index
+    bool m_blocked = false;
+    std::chrono::steady_clock::time_point m_blocked_since;
+    uint64_t m_blocked_index = 0;
+
+    /// Expire symbols this many indices behind the upper bound, zero to
+    /// disable
+    uint64_t m_deadline_symbols = 0;
+
+    /// Expire symbols this many seconds after they are pushed, zero to
+    /// disable
+    double m_deadline_seconds = 0.0;
+
+    /// The upper bound of the stream after each push and its timestamp,
+    /// oldest first
+    std::deque<std::pair<uint64_t, double>> m_timestamps;
+
+    /// The number of undecoded symbols popped because they expired
+    uint64_t m_expired_symbols = 0;
+
+    std::function<void(uint64_t index)> m_on_symbol_expired;
+
     ~decoder_wrapper()
     {
         if (configured)
@@ -60,13 +115,28 @@ struct decoder_wrapper : kodo::slide::decoder
             reset(
                 [](uint64_t index, const uint8_t* symbol, void* user_data)
                 {
-                    (void)user_data;
                     (void)index;
-                    delete[] symbol;
+                    static_cast<decoder_wrapper*>(user_data)->release_symbol(
+                        symbol);
                 },
-                nullptr);
+                this);
         }
+        m_exports->collect();
     };
+
+    /// @return A buffer for a symbol handed to the decoder
+    auto acquire_symbol() -> uint8_t*
+    {
+        m_exports->collect();
+        return m_pool->acquire();
+    }
+
+    /// Put the buffer of a symbol back in the pool, once its views are
+    /// released
+    void release_symbol(const uint8_t* symbol)
+    {
+        m_exports->retire(m_pool, symbol);
+    }
 };
 
 using decoder_type = decoder_wrapper;
@@ -79,6 +149,7 @@ void slide_decoder_enable_log(
     decoder.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             decoder_type* decoder = static_cast<decoder_type*>(data);
             assert(decoder->m_log_callback);
             decoder->m_log_callback(name, message);
@@ -94,6 +165,7 @@ void slide_decoder_on_symbol_decoded(
     decoder.on_symbol_decoded(
         [](uint64_t index, void* user_data)
         {
+            pybind11::gil_scoped_acquire acquire;
             decoder_type* decoder = static_cast<decoder_type*>(user_data);
             assert(decoder->m_on_symbol_decoded);
             decoder->m_on_symbol_decoded(index);
@@ -101,6 +173,13 @@ void slide_decoder_on_symbol_decoded(
         &decoder);
 }
 
+void slide_decoder_on_symbol_expired(
+    decoder_type& decoder,
+    std::function<void(uint64_t index)> on_symbol_expired)
+{
+    decoder.m_on_symbol_expired = on_symbol_expired;
+}
+
 void slide_decoder_on_symbol_pivot(
     decoder_type& decoder, std::function<void(uint64_t index)> on_symbol_pivot)
 {
@@ -108,6 +187,7 @@ void slide_decoder_on_symbol_pivot(
     decoder.on_symbol_pivot(
         [](uint64_t index, void* user_data)
         {
+            pybind11::gil_scoped_acquire acquire;
             decoder_type* decoder = static_cast<decoder_type*>(user_data);
             assert(decoder->m_on_symbol_pivot);
             decoder->m_on_symbol_pivot(index);
@@ -117,127 +197,448 @@ void slide_decoder_on_symbol_pivot(
 
 void slide_decoder_reset(decoder_type& decoder)
 {
-
     decoder.reset(
         [](uint64_t index, const uint8_t* symbol, void* user_data)
         {
-            (void)user_data;
             (void)index;
-            delete[] symbol;
+            static_cast<decoder_type*>(user_data)->release_symbol(symbol);
         },
-        nullptr);
+        &decoder);
+
+    decoder.m_delivery_index = 0;
+    decoder.m_skipped_symbols = 0;
+    decoder.m_blocked = false;
+    decoder.m_timestamps.clear();
+    decoder.m_expired_symbols = 0;
 }
 
 void slide_decoder_configure(decoder_type& decoder,
-                             std::size_t max_max_symbol_bytes)
+                             std::size_t max_max_symbol_bytes,
+                             std::size_t capacity)
 {
     if (decoder.configured)
     {
         slide_decoder_reset(decoder);
     }
     decoder.configure(max_max_symbol_bytes);
+
+    // Buffers still exported go back to the old pool, so they are not
+    // reused with another size
+    if (decoder.m_exports->is_exported())
+    {
+        decoder.m_pool = std::make_shared<symbol_pool>();
+    }
+    decoder.m_exports->collect();
+    decoder.m_pool->configure(max_max_symbol_bytes);
+    decoder.m_capacity = capacity;
     decoder.configured = true;
 }
 
-auto slide_decoder_stream_range(decoder_type& decoder) -> pybind11::tuple
+auto slide_decoder_stream_range(decoder_type& decoder) -> kodo::slide::range
+{
+    return decoder.stream_range();
+}
+
+/// @return The timestamp in seconds, the steady clock if it is None
+double slide_decoder_timestamp(pybind11::object timestamp)
+{
+    if (!timestamp.is_none())
+    {
+        return timestamp.cast<double>();
+    }
+
+    std::chrono::duration<double> now =
+        std::chrono::steady_clock::now().time_since_epoch();
+    return now.count();
+}
+
+/// Record the timestamp of newly pushed symbols and pop the symbols which
+/// passed the deadline, reporting the undecoded ones as expired
+void slide_decoder_expire(decoder_type& decoder, double now)
+{
+    auto& timestamps = decoder.m_timestamps;
+    uint64_t upper_bound = decoder.stream_upper_bound();
+
+    if (decoder.m_deadline_seconds > 0.0 &&
+        (timestamps.empty() || timestamps.back().first < upper_bound))
+    {
+        timestamps.emplace_back(upper_bound, now);
+    }
+
+    uint64_t expired_bound = 0;
+    if (decoder.m_deadline_symbols != 0 &&
+        upper_bound > decoder.m_deadline_symbols)
+    {
+        expired_bound = upper_bound - decoder.m_deadline_symbols;
+    }
+
+    if (decoder.m_deadline_seconds > 0.0)
+    {
+        while (!timestamps.empty() &&
+               timestamps.front().second + decoder.m_deadline_seconds <= now)
+        {
+            expired_bound = std::max(expired_bound, timestamps.front().first);
+            timestamps.pop_front();
+        }
+    }
+
+    while (decoder.stream_symbols() != 0 &&
+           decoder.stream_lower_bound() < expired_bound)
+    {
+        uint64_t index = decoder.stream_lower_bound();
+        bool decoded = decoder.is_symbol_decoded(index);
+
+        decoder.release_symbol(decoder.pop_symbol());
+
+        if (!decoded)
+        {
+            ++decoder.m_expired_symbols;
+            if (decoder.m_on_symbol_expired)
+            {
+                decoder.m_on_symbol_expired(index);
+            }
+        }
+    }
+
+    // Drop the timestamps of symbols popped elsewhere
+    while (!timestamps.empty() &&
+           timestamps.front().first <= decoder.stream_lower_bound())
+    {
+        timestamps.pop_front();
+    }
+}
+
+void slide_decoder_configure_deadline(decoder_type& decoder,
+                                      pybind11::object max_symbols,
+                                      pybind11::object max_age)
+{
+    uint64_t symbols = max_symbols.is_none() ? 0 : max_symbols.cast<uint64_t>();
+    double seconds = max_age.is_none() ? 0.0 : max_age.cast<double>();
+
+    if (!max_symbols.is_none() && symbols == 0)
+    {
+        throw pybind11::value_error("max_symbols: must be greater than zero");
+    }
+    if (!max_age.is_none() && !(seconds > 0.0))
+    {
+        throw pybind11::value_error("max_age: must be greater than zero");
+    }
+
+    decoder.m_deadline_symbols = symbols;
+    decoder.m_deadline_seconds = seconds;
+    decoder.m_timestamps.clear();
+}
+
+void slide_decoder_expire_symbols(decoder_type& decoder, pybind11::object now)
 {
-    kodo::slide::range range = decoder.stream_range();
-    pybind11::tuple stream_tuple =
-        pybind11::make_tuple(range.lower_bound(), range.upper_bound());
-    return stream_tuple;
+    slide_decoder_expire(decoder, slide_decoder_timestamp(now));
 }
 
-void slide_decoder_push_symbol(decoder_type& decoder)
+void slide_decoder_push_symbol(decoder_type& decoder,
+                               pybind11::object timestamp)
 {
     decoder.push_symbol();
+    slide_decoder_expire(decoder, slide_decoder_timestamp(timestamp));
 }
 
 void slide_decoder_pop_symbol(decoder_type& decoder)
 {
     assert(decoder.stream_symbols() != 0);
-    auto ptr = decoder.pop_symbol();
-    if (ptr == nullptr)
+    decoder.release_symbol(decoder.pop_symbol());
+}
+
+void slide_decoder_advance_to(decoder_type& decoder, uint64_t upper_bound,
+                              pybind11::object capacity_object,
+                              pybind11::object timestamp)
+{
+    std::size_t capacity = capacity_object.is_none()
+                               ? decoder.m_capacity
+                               : capacity_object.cast<std::size_t>();
+    if (capacity == 0)
     {
-        return;
+        throw pybind11::value_error(
+            "capacity: must be greater than zero or set with configure");
     }
 
-    delete[] ptr;
+    double now = slide_decoder_timestamp(timestamp);
+
+    if (upper_bound > decoder.stream_upper_bound())
+    {
+        pybind11::gil_scoped_release release;
+
+        // After a large jump none of the current symbols stay in the
+        // stream, so drop them all and move the stream instead of pushing
+        // every symbol in between
+        if (upper_bound - decoder.stream_upper_bound() > capacity)
+        {
+            while (decoder.stream_symbols() != 0)
+            {
+                decoder.release_symbol(decoder.pop_symbol());
+            }
+            decoder.set_stream_lower_bound(upper_bound - capacity);
+        }
+
+        while (decoder.stream_upper_bound() < upper_bound)
+        {
+            if (decoder.stream_symbols() >= capacity)
+            {
+                decoder.release_symbol(decoder.pop_symbol());
+            }
+            decoder.push_symbol();
+        }
+    }
+
+    slide_decoder_expire(decoder, now);
 }
 
 auto slide_decoder_symbol_data(decoder_type& decoder, std::size_t index)
-    -> pybind11::bytearray
+    -> pybind11::object
 {
+    if (!decoder.in_stream(index))
+    {
+        return pybind11::none{};
+    }
     auto symbol = decoder.symbol_data(index);
     auto size = decoder.symbol_bytes(index);
+
+    return pybind11::bytearray{(char*)symbol, size};
+}
+
+auto slide_decoder_symbol_view(decoder_type& decoder, std::size_t index)
+    -> pybind11::object
+{
     if (!decoder.in_stream(index))
     {
         return pybind11::none{};
     }
 
-    return pybind11::bytearray{(char*)symbol, size};
+    auto symbol = decoder.symbol_data(index);
+    if (symbol == nullptr)
+    {
+        return pybind11::none{};
+    }
+    return make_memoryview(pybind11::cast(&decoder), symbol,
+                           decoder.symbol_bytes(index),
+                           decoder.m_exports->pin(symbol));
 }
 
-void slide_decoder_decode_symbol(decoder_type& decoder,
-                                 pybind11::bytearray symbol_bytearray,
-                                 pybind11::tuple window_tuple,
-                                 pybind11::bytearray coefficients)
+auto slide_decoder_symbols_view(decoder_type& decoder) -> pybind11::list
 {
-    if (coefficients.size() == 0)
+    pybind11::list views;
+    for (auto index = decoder.stream_lower_bound();
+         index < decoder.stream_upper_bound(); ++index)
     {
-        throw pybind11::value_error("coefficients: length is 0.");
+        views.append(slide_decoder_symbol_view(decoder, index));
     }
+    return views;
+}
 
-    kodo::slide::range range = py_tuple_to_range(window_tuple);
+void slide_decoder_configure_delivery(decoder_type& decoder,
+                                      pybind11::object max_gap,
+                                      pybind11::object max_hold)
+{
+    std::size_t gap = max_gap.is_none() ? 0 : max_gap.cast<std::size_t>();
+    double hold = max_hold.is_none() ? 0.0 : max_hold.cast<double>();
 
-    auto size = symbol_bytearray.size();
+    if (!max_gap.is_none() && gap == 0)
+    {
+        throw pybind11::value_error("max_gap: must be greater than zero");
+    }
+    if (!max_hold.is_none() && !(hold > 0.0))
+    {
+        throw pybind11::value_error("max_hold: must be greater than zero");
+    }
+
+    decoder.m_max_gap = gap;
+    decoder.m_max_hold =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(hold));
+    decoder.m_blocked = false;
+}
+
+/// @return True if the undecoded symbol at the delivery index should be
+///         skipped
+bool slide_decoder_skip_hole(decoder_type& decoder,
+                             std::chrono::steady_clock::time_point now)
+{
+    uint64_t index = decoder.m_delivery_index;
+    uint64_t following = decoder.stream_upper_bound() - index;
+
+    // Nothing is waiting behind the newest symbol. Its hold time starts
+    // when symbols arrive after it, not with an earlier hole
+    if (following <= 1)
+    {
+        if (decoder.m_blocked && decoder.m_blocked_index != index)
+        {
+            decoder.m_blocked = false;
+        }
+        return false;
+    }
 
-    uint8_t* symbol = new uint8_t[decoder.max_symbol_bytes()];
-    memcpy(symbol, (uint8_t*)PyByteArray_AsString(symbol_bytearray.ptr()),
-           size);
+    if (decoder.m_max_gap != 0 && following > decoder.m_max_gap)
+    {
+        return true;
+    }
 
-    auto ptr = decoder.decode_symbol(
-        symbol, size, range,
-        (uint8_t*)PyByteArray_AsString(coefficients.ptr()));
+    if (decoder.m_max_hold == std::chrono::steady_clock::duration::zero())
+    {
+        return false;
+    }
 
-    if (ptr == nullptr)
+    if (!decoder.m_blocked)
     {
-        return;
+        decoder.m_blocked = true;
+        decoder.m_blocked_since = now;
+        decoder.m_blocked_index = index;
+        return false;
     }
 
-    delete[] ptr;
+    // Once the hold time has passed, the holes up to the next decoded
+    // symbol are all skipped
+    return now - decoder.m_blocked_since >= decoder.m_max_hold;
 }
 
-void slide_decoder_decode_systematic_symbol(
-    decoder_type& decoder, pybind11::bytearray symbol_bytearray,
-    std::size_t index)
+auto slide_decoder_deliver_symbols(decoder_type& decoder) -> pybind11::list
 {
-    if (symbol_bytearray.size() > decoder.max_symbol_bytes())
+    pybind11::list symbols;
+    pybind11::object owner = pybind11::cast(&decoder);
+
+    // Symbols which left the stream can no longer be delivered
+    if (decoder.m_delivery_index < decoder.stream_lower_bound())
     {
-        throw pybind11::value_error(
-            "symbol: bytearray too large. Must be less "
-            "than or equal to decoder.max_symbol_bytes");
+        decoder.m_skipped_symbols +=
+            decoder.stream_lower_bound() - decoder.m_delivery_index;
+        decoder.m_delivery_index = decoder.stream_lower_bound();
+        decoder.m_blocked = false;
     }
 
-    if (!decoder.in_stream(index))
+    auto now = std::chrono::steady_clock::now();
+
+    while (decoder.m_delivery_index < decoder.stream_upper_bound())
     {
-        throw pybind11::value_error("index: out of range, must be in stream.");
+        uint64_t index = decoder.m_delivery_index;
+
+        if (decoder.is_symbol_decoded(index))
+        {
+            auto symbol = decoder.symbol_data(index);
+            symbols.append(pybind11::make_tuple(
+                index, make_memoryview(owner, symbol,
+                                       decoder.symbol_bytes(index),
+                                       decoder.m_exports->pin(symbol))));
+            decoder.m_blocked = false;
+        }
+        else if (slide_decoder_skip_hole(decoder, now))
+        {
+            ++decoder.m_skipped_symbols;
+        }
+        else
+        {
+            break;
+        }
+
+        ++decoder.m_delivery_index;
     }
+    return symbols;
+}
 
-    auto size = symbol_bytearray.size();
+auto slide_decoder_feedback(decoder_type& decoder) -> pybind11::bytes
+{
+    uint64_t lower_bound = decoder.stream_lower_bound();
+    uint64_t upper_bound = decoder.stream_upper_bound();
 
-    uint8_t* symbol = new uint8_t[decoder.max_symbol_bytes()];
+    // Everything before the first missing symbol is implied by lower_bound
+    while (lower_bound < upper_bound && decoder.is_symbol_decoded(lower_bound))
+    {
+        ++lower_bound;
+    }
+    uint64_t symbols = upper_bound - lower_bound;
 
-    memcpy(symbol, (uint8_t*)PyByteArray_AsString(symbol_bytearray.ptr()),
-           size);
+    std::vector<uint8_t> data;
+    feedback::write_varint(data, lower_bound);
+    feedback::write_varint(data, symbols);
 
-    auto ptr = decoder.decode_systematic_symbol(symbol, size, index);
+    auto bytes = feedback::bitmap_bytes(symbols);
+    auto offset = data.size();
+    data.resize(offset + 2 * bytes, 0);
 
-    if (ptr == nullptr)
+    uint8_t* decoded = data.data() + offset;
+    uint8_t* pivot = decoded + bytes;
+    for (uint64_t i = 0; i < symbols; ++i)
     {
-        return;
+        if (decoder.is_symbol_decoded(lower_bound + i))
+        {
+            feedback::set_bit(decoded, i);
+        }
+        if (decoder.is_symbol_pivot(lower_bound + i))
+        {
+            feedback::set_bit(pivot, i);
+        }
     }
 
-    delete[] ptr;
+    return pybind11::bytes{(char*)data.data(), data.size()};
+}
+
+void slide_decoder_decode_symbol(decoder_type& decoder,
+                                 pybind11::buffer symbol_buffer,
+                                 pybind11::object window,
+                                 pybind11::buffer coefficients)
+{
+    buffer_view symbol_view(symbol_buffer, false, "symbol");
+    buffer_view coefficients_view(coefficients, true, "coefficients");
+
+    if (coefficients_view.size() == 0)
+    {
+        throw pybind11::value_error("coefficients: length is 0.");
+    }
+
+    if (symbol_view.size() > decoder.max_symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: buffer too large. Must be less "
+            "than or equal to decoder.max_symbol_bytes");
+    }
+
+    kodo::slide::range range = py_window_to_range(window);
+
+    auto size = symbol_view.size();
+
+    pybind11::gil_scoped_release release;
+
+    uint8_t* symbol = decoder.acquire_symbol();
+    std::memcpy(symbol, symbol_view.data(), size);
+
+    // The decoder hands back the buffer it no longer needs, if any
+    decoder.release_symbol(decoder.decode_symbol(symbol, size, range,
+                                                 coefficients_view.data()));
+}
+
+void slide_decoder_decode_systematic_symbol(decoder_type& decoder,
+                                            pybind11::buffer symbol_buffer,
+                                            std::size_t index)
+{
+    buffer_view symbol_view(symbol_buffer, false, "symbol");
+
+    if (symbol_view.size() > decoder.max_symbol_bytes())
+    {
+        throw pybind11::value_error(
+            "symbol: buffer too large. Must be less "
+            "than or equal to decoder.max_symbol_bytes");
+    }
+
+    if (!decoder.in_stream(index))
+    {
+        throw pybind11::value_error("index: out of range, must be in stream.");
+    }
+
+    auto size = symbol_view.size();
+
+    pybind11::gil_scoped_release release;
+
+    uint8_t* symbol = decoder.acquire_symbol();
+    std::memcpy(symbol, symbol_view.data(), size);
+
+    decoder.release_symbol(
+        decoder.decode_systematic_symbol(symbol, size, index));
 }
 }
 
@@ -249,12 +650,28 @@ void decoder(pybind11::module& m)
              "The sliding window decoder constructor\n\n"
              "\t:param field: the chosen finite field.\n")
         .def("configure", &slide_decoder_configure, arg("max_symbol_bytes"),
+             arg("capacity") = 0,
              "Configure the decoder with the given parameters. This is also "
              "useful for reusing an existing coder. Note that the "
              "reconfiguration always implies a reset, so the decoder will "
              "be in a clean state after this operation.\n\n"
-             "\t:param max_symbol_bytes: The size of a symbol in bytes.\n")
+             "\t:param max_symbol_bytes: The size of a symbol in bytes.\n"
+             "\t:param capacity: The default capacity used by "
+             "Decoder.advance_to().\n")
         .def("reset", &slide_decoder_reset, "Reset the state of the decoder.\n")
+        .def_property_readonly(
+            "pool_hits",
+            [](const decoder_type& decoder)
+            { return decoder.m_pool->hits(); },
+            "Return the number of received symbols stored in a reused "
+            "buffer.\n")
+        .def_property_readonly(
+            "pool_misses",
+            [](const decoder_type& decoder)
+            { return decoder.m_pool->misses(); },
+            "Return the number of received symbols for which a buffer was "
+            "allocated. In steady state, when symbols are popped as fast as "
+            "they are pushed, this stops increasing.\n")
         .def_property_readonly("field", &decoder_type::field,
                                "Return the finite field used.\n")
         .def_property_readonly(
@@ -278,7 +695,7 @@ void decoder(pybind11::module& m)
                                &decoder_type::stream_upper_bound,
                                "Return the upper bound of the stream.\n")
         .def_property_readonly("stream_range", &slide_decoder_stream_range,
-                               "Return a tuple containing the lower- and upper "
+                               "Return a Range containing the lower- and upper "
                                "bound of the stream.\n")
         .def("in_stream", &decoder_type::in_stream, arg("index"),
              "Return True if the stream contains a symbol with the given "
@@ -293,9 +710,52 @@ void decoder(pybind11::module& m)
              "lower bound must be larger than or equal to the prior lower "
              "bound.\n")
         .def("push_symbol", &slide_decoder_push_symbol,
+             arg("timestamp") = none(),
              "Adds a new symbol to the front of the decoder. Increments the "
              "number of symbols in the stream and increases the "
-             "Decoder.stream_upper_bound\n")
+             "Decoder.stream_upper_bound\n\n"
+             ":param timestamp: The time in seconds the symbol is pushed at, "
+             "used by Decoder.configure_deadline(). If None the monotonic "
+             "clock is used.\n")
+        .def("advance_to", &slide_decoder_advance_to, arg("upper_bound"),
+             arg("capacity") = none(), arg("timestamp") = none(),
+             "Push symbols until Decoder.stream_upper_bound reaches "
+             "upper_bound, popping the oldest symbols to keep at most "
+             "capacity symbols in the stream. This replaces a loop of "
+             "push_symbol() and pop_symbol() calls, and after a jump of more "
+             "than capacity symbols the stream is moved instead of pushing "
+             "every symbol in between.\n\n"
+             ":param upper_bound: The new stream upper bound, e.g. "
+             "Encoder.stream_upper_bound. Nothing is done if the stream is "
+             "already there.\n"
+             ":param capacity: The maximum number of symbols in the stream. "
+             "If None the capacity given to configure() is used.\n"
+             ":param timestamp: The time in seconds the symbols are pushed "
+             "at, see push_symbol().\n")
+        .def("configure_deadline", &slide_decoder_configure_deadline,
+             arg("max_symbols") = none(), arg("max_age") = none(),
+             "Configure a deadline after which symbols are popped from the "
+             "stream, so old undecoded symbols stop adding to the decoding "
+             "work. The deadline is checked by push_symbol(), advance_to() "
+             "and expire_symbols(). Undecoded symbols popped this way are "
+             "reported to the on_symbol_expired() callback.\n\n"
+             ":param max_symbols: Expire symbols more than max_symbols "
+             "indices behind Decoder.stream_upper_bound, or None.\n"
+             ":param max_age: Expire symbols max_age seconds after they were "
+             "pushed, or None. The timestamps passed to push_symbol(), "
+             "advance_to() and expire_symbols() must use the same clock.\n")
+        .def("expire_symbols", &slide_decoder_expire_symbols,
+             arg("now") = none(),
+             "Pop the symbols which passed the deadline set with "
+             "configure_deadline(), e.g. when no packets arrive.\n\n"
+             ":param now: The current time in seconds. If None the monotonic "
+             "clock is used.\n")
+        .def_property_readonly(
+            "expired_symbols",
+            [](const decoder_type& decoder)
+            { return decoder.m_expired_symbols; },
+            "Return the number of undecoded symbols popped because they "
+            "passed the deadline.\n")
         .def("pop_symbol", &slide_decoder_pop_symbol,
              "Remove the \"oldest\" symbol from the stream. Increments the"
              "Decoder.stream_lower_bound\n")
@@ -306,8 +766,9 @@ void decoder(pybind11::module& m)
              ":param symbol: The buffer where the decoded symbol will be "
              "stored. The"
              "\tsymbol must be Decoder.max_symbol_bytes large."
-             ":param window: A tuple of two integers. A lower bound and an "
-             "upper_bound of the packet indices included in the encoded symbol."
+             ":param window: A Range, or a tuple of two integers, with the "
+             "lower and upper bound of the packet indices included in the "
+             "encoded symbol."
              ":param coefficients: The coding coefficients. These must "
              "have the"
              "\tmemory layout required (see README.rst). A compatible "
@@ -340,6 +801,50 @@ void decoder(pybind11::module& m)
         .def("symbol_data", &slide_decoder_symbol_data, arg("index"),
              "Get a symbol from the stream.\n\n"
              ":param index: The index of the symbol to get.")
+        .def("configure_delivery", &slide_decoder_configure_delivery,
+             arg("max_gap") = none(), arg("max_hold") = none(),
+             "Configure when Decoder.deliver_symbols() gives up on a missing "
+             "symbol and skips it. Without limits delivery waits until the "
+             "symbol is decoded or leaves the stream.\n\n"
+             ":param max_gap: Skip a missing symbol once more than max_gap "
+             "symbols are in the stream from it onwards, or None.\n"
+             ":param max_hold: Skip missing symbols once they have blocked "
+             "delivery for max_hold seconds, or None.\n")
+        .def("deliver_symbols", &slide_decoder_deliver_symbols,
+             "Deliver the decoded symbols in order. Returns a list of "
+             "(index, memoryview) tuples for the symbols decoded since the "
+             "last call, starting at Decoder.delivery_index and stopping at "
+             "the first missing symbol which is not skipped, see "
+             "Decoder.configure_delivery(). Only the delivered symbols are "
+             "visited, not the whole stream. Like symbol_view() no copy is "
+             "made and the views stay valid after the symbols are popped "
+             "from the stream.\n")
+        .def_property_readonly(
+            "delivery_index",
+            [](const decoder_type& decoder)
+            { return decoder.m_delivery_index; },
+            "Return the index of the next symbol to deliver in order.\n")
+        .def_property_readonly(
+            "skipped_symbols",
+            [](const decoder_type& decoder)
+            { return decoder.m_skipped_symbols; },
+            "Return the number of symbols skipped by the in-order "
+            "delivery.\n")
+        .def("feedback", &slide_decoder_feedback,
+             "Return the decoding state as compact feedback for "
+             "Encoder.apply_feedback(). It holds the first symbol still "
+             "needed as a varint followed by bitmaps of the decoded and "
+             "pivot symbols from there to Decoder.stream_upper_bound, so its "
+             "size is a few bytes plus two bits per symbol.\n")
+        .def("symbol_view", &slide_decoder_symbol_view, arg("index"),
+             "Get a read-only memoryview of a symbol in the stream or None "
+             "if it is not in the stream. Unlike symbol_data no copy is "
+             "made. The memory of the symbol is not reused while the view "
+             "exists, also after the symbol is popped from the stream.\n\n"
+             ":param index: The index of the symbol to get.")
+        .def("symbols_view", &slide_decoder_symbols_view,
+             "Get a list of read-only memoryviews of the symbols in the "
+             "stream, ordered by index from stream_lower_bound.\n")
         .def("is_symbol_decoded", &decoder_type::is_symbol_decoded,
              arg("index"),
              ":param index: The index of the symbol to check.\n\n"
@@ -351,6 +856,13 @@ void decoder(pybind11::module& m)
              "Sets a callback to be executed when a symbol is decoded.\n\n"
              ":param decoding_callback: A function that takes an index and has "
              "no return value.\n")
+        .def("on_symbol_expired", &slide_decoder_on_symbol_expired,
+             arg("expired_callback"),
+             "Sets a callback to be executed when an undecoded symbol is "
+             "popped because it passed the deadline, see "
+             "configure_deadline().\n\n"
+             ":param expired_callback: A function that takes an index and "
+             "has no return value.\n")
         .def("on_symbol_pivot", &slide_decoder_on_symbol_pivot,
              arg("pivot_callback"),
              "Sets a callback to be executed when a symbol is found to be "
@@ -19,8 +19,15 @@
 // See accompanying file LICENSE.rst or https://www.steinwurf.com/license
 
 #include "encoder.hpp"
+#include "feedback.hpp"
+#include "symbol_arena.hpp"
+#include "symbol_exports.hpp"
 #include "tuple_to_range.hpp"
 
+#include "generator/random_uniform.hpp"
+
+#include "../buffer.hpp"
+#include "../memory_view.hpp"
 #include "../version.hpp"
 
 #include <pybind11/pybind11.h>
@@ -30,6 +37,8 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -49,6 +58,13 @@ struct encoder_wrapper : kodo::slide::encoder
     std::function<void(const std::string&, const std::string&)> m_log_callback;
     bool configured = false;
 
+    /// The memory of the symbols in the stream
+    std::shared_ptr<symbol_arena> m_arena = std::make_shared<symbol_arena>();
+
+    /// The symbols exported through memoryviews
+    std::shared_ptr<symbol_exports> m_exports =
+        std::make_shared<symbol_exports>();
+
     ~encoder_wrapper()
     {
         if (configured)
@@ -56,12 +72,27 @@ struct encoder_wrapper : kodo::slide::encoder
             reset(
                 [](uint64_t index, const uint8_t* symbol, void* user_data)
                 {
-                    (void)user_data;
                     (void)index;
-                    delete[] symbol;
+                    static_cast<encoder_wrapper*>(user_data)->release_symbol(
+                        symbol);
                 },
-                nullptr);
+                this);
         }
+        m_exports->collect();
+    }
+
+    /// @return Memory for a symbol pushed to the stream
+    auto allocate_symbol() -> uint8_t*
+    {
+        m_exports->collect();
+        return m_arena->allocate();
+    }
+
+    /// Release the memory of a symbol which left the stream, once its
+    /// views are released
+    void release_symbol(const uint8_t* symbol)
+    {
+        m_exports->retire(m_arena, symbol);
     }
 };
 using encoder_type = encoder_wrapper;
@@ -74,6 +105,7 @@ void slide_encoder_enable_log(
     encoder.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             encoder_type* encoder = static_cast<encoder_type*>(data);
             assert(encoder->m_log_callback);
             encoder->m_log_callback(name, message);
@@ -86,36 +118,44 @@ void slide_encoder_reset(encoder_type& encoder)
     encoder.reset(
         [](uint64_t index, const uint8_t* symbol, void* user_data)
         {
-            (void)user_data;
             (void)index;
-            delete[] symbol;
+            static_cast<encoder_type*>(user_data)->release_symbol(symbol);
         },
-        nullptr);
+        &encoder);
 }
 
 void slide_encoder_configure(encoder_type& encoder,
-                             std::size_t max_symbol_bytes)
+                             std::size_t max_symbol_bytes,
+                             std::size_t capacity)
 {
     if (encoder.configured)
     {
         slide_encoder_reset(encoder);
     }
     encoder.configure(max_symbol_bytes);
+
+    // Symbols still exported keep the old arena alive, the new
+    // configuration gets an arena of its own
+    if (encoder.m_exports->is_exported())
+    {
+        encoder.m_arena = std::make_shared<symbol_arena>();
+    }
+    encoder.m_exports->collect();
+    encoder.m_arena->configure(max_symbol_bytes, capacity);
     encoder.configured = true;
 }
 
-auto slide_encoder_stream_range(encoder_type& encoder) -> pybind11::tuple
+auto slide_encoder_stream_range(encoder_type& encoder) -> kodo::slide::range
 {
-    kodo::slide::range range = encoder.stream_range();
-    pybind11::tuple stream_tuple =
-        pybind11::make_tuple(range.lower_bound(), range.upper_bound());
-    return stream_tuple;
+    return encoder.stream_range();
 }
 
 void slide_encoder_push_symbol(encoder_type& encoder,
-                               pybind11::bytearray symbol_bytearray)
+                               pybind11::buffer symbol_buffer)
 {
-    auto size = symbol_bytearray.size();
+    buffer_view symbol_view(symbol_buffer, false, "symbol");
+
+    auto size = symbol_view.size();
     if (size > encoder.max_symbol_bytes())
     {
         throw pybind11::value_error(
@@ -123,12 +163,59 @@ void slide_encoder_push_symbol(encoder_type& encoder,
             "than or equal");
     }
 
-    uint8_t* symbol = new uint8_t[size];
-    std::memcpy((uint8_t*)PyByteArray_AsString(symbol_bytearray.ptr()), symbol,
-                size);
+    uint8_t* symbol = encoder.allocate_symbol();
+    std::memcpy(symbol, symbol_view.data(), size);
     encoder.push_symbol(symbol, size);
 }
 
+auto slide_encoder_push_symbols(encoder_type& encoder,
+                                pybind11::buffer symbols_buffer,
+                                pybind11::sequence lengths_sequence)
+    -> kodo::slide::range
+{
+    buffer_view symbols_view(symbols_buffer, false, "symbols");
+
+    std::vector<std::size_t> lengths;
+    lengths.reserve(lengths_sequence.size());
+
+    std::size_t total = 0;
+    for (auto length_object : lengths_sequence)
+    {
+        auto length = length_object.cast<std::size_t>();
+        if (length > encoder.max_symbol_bytes())
+        {
+            throw pybind11::value_error(
+                "lengths: greater than encoder.max_symbol_bytes(). Must be "
+                "less than or equal");
+        }
+        total += length;
+        lengths.push_back(length);
+    }
+
+    if (total != symbols_view.size())
+    {
+        throw pybind11::value_error(
+            "lengths: the sum must be equal to the size of symbols");
+    }
+
+    auto lower_bound = encoder.stream_upper_bound();
+
+    {
+        pybind11::gil_scoped_release release;
+
+        const uint8_t* data = symbols_view.data();
+        for (auto length : lengths)
+        {
+            uint8_t* symbol = encoder.allocate_symbol();
+            std::memcpy(symbol, data, length);
+            encoder.push_symbol(symbol, length);
+            data += length;
+        }
+    }
+
+    return kodo::slide::range(lower_bound, encoder.stream_upper_bound());
+}
+
 auto slide_encoder_symbol_data(encoder_type& encoder, std::size_t index)
     -> pybind11::bytearray
 {
@@ -141,6 +228,29 @@ auto slide_encoder_symbol_data(encoder_type& encoder, std::size_t index)
     return pybind11::bytearray{(char*)symbol, size};
 }
 
+auto slide_encoder_symbol_view(encoder_type& encoder, std::size_t index)
+    -> pybind11::memoryview
+{
+    if (!encoder.in_stream(index))
+        throw pybind11::value_error("index not in stream");
+
+    auto symbol = encoder.symbol_data(index);
+    return make_memoryview(pybind11::cast(&encoder), symbol,
+                           encoder.symbol_bytes(index),
+                           encoder.m_exports->pin(symbol));
+}
+
+auto slide_encoder_symbols_view(encoder_type& encoder) -> pybind11::list
+{
+    pybind11::list views;
+    for (auto index = encoder.stream_lower_bound();
+         index < encoder.stream_upper_bound(); ++index)
+    {
+        views.append(slide_encoder_symbol_view(encoder, index));
+    }
+    return views;
+}
+
 auto slide_encoder_in_stream(encoder_type& encoder, std::size_t index) -> bool
 {
     return encoder.in_stream(index);
@@ -151,31 +261,130 @@ void slide_encoder_pop_symbol(encoder_type& encoder)
     if (encoder.is_stream_empty())
         throw pybind11::value_error("Stream was empty");
 
-    auto symbol = encoder.pop_symbol();
-    delete[] symbol;
+    encoder.release_symbol(encoder.pop_symbol());
+}
+
+auto slide_encoder_apply_feedback(encoder_type& encoder,
+                                  pybind11::buffer feedback_buffer)
+    -> std::size_t
+{
+    buffer_view feedback_view(feedback_buffer, false, "feedback");
+
+    feedback::message message;
+    if (!feedback::parse(feedback_view.data(), feedback_view.size(), message))
+    {
+        throw pybind11::value_error("feedback: malformed");
+    }
+
+    // The decoder no longer needs the symbols before its lower bound
+    while (!encoder.is_stream_empty() &&
+           encoder.stream_lower_bound() < message.lower_bound)
+    {
+        encoder.release_symbol(encoder.pop_symbol());
+    }
+
+    std::size_t missing = 0;
+    for (auto index = encoder.stream_lower_bound();
+         index < encoder.stream_upper_bound(); ++index)
+    {
+        uint64_t offset = index - message.lower_bound;
+        if (index < message.lower_bound || offset >= message.symbols ||
+            !feedback::is_set(message.pivot, offset))
+        {
+            ++missing;
+        }
+    }
+    return missing;
 }
 
 auto slide_encoder_encode_symbol(encoder_type& encoder,
-                                 pybind11::tuple window_handle,
-                                 pybind11::bytearray coefficients)
+                                 pybind11::object window,
+                                 pybind11::buffer coefficients)
     -> pybind11::bytearray
 {
-    if (coefficients.size() == 0)
+    buffer_view coefficients_view(coefficients, false, "coefficients");
+
+    if (coefficients_view.size() == 0)
     {
         throw pybind11::value_error("coefficients: length is 0.");
     }
 
-    kodo::slide::range range = py_tuple_to_range(window_handle);
+    kodo::slide::range range = py_window_to_range(window);
 
     std::vector<uint8_t> symbol(encoder.max_symbol_bytes());
 
-    auto size = encoder.encode_symbol(
-        symbol.data(), range,
-        (uint8_t*)PyByteArray_AsString(coefficients.ptr()));
+    std::size_t size;
+    {
+        pybind11::gil_scoped_release release;
+        size = encoder.encode_symbol(symbol.data(), range,
+                                     coefficients_view.data());
+    }
 
     return pybind11::bytearray{(char*)symbol.data(), size};
 }
 
+auto slide_encoder_encode_repairs(encoder_type& encoder,
+                                  generator::random_uniform_type& generator,
+                                  pybind11::object window,
+                                  pybind11::sequence seeds_sequence)
+    -> pybind11::list
+{
+    if (generator.field() != encoder.field())
+    {
+        throw pybind11::value_error(
+            "generator: must use the same field as the encoder");
+    }
+
+    kodo::slide::range range = py_window_to_range(window);
+    if (range.lower_bound() == range.upper_bound() ||
+        range.lower_bound() < encoder.stream_lower_bound() ||
+        range.upper_bound() > encoder.stream_upper_bound())
+    {
+        throw pybind11::value_error(
+            "window: must be a non-empty range within the stream");
+    }
+
+    std::vector<uint64_t> seeds;
+    seeds.reserve(seeds_sequence.size());
+    for (auto seed : seeds_sequence)
+    {
+        seeds.push_back(seed.cast<uint64_t>());
+    }
+
+    auto coefficients_bytes = generator.coefficients_bytes(range);
+    auto max_symbol_bytes = encoder.max_symbol_bytes();
+
+    std::vector<uint8_t> coefficients(coefficients_bytes * seeds.size());
+    std::vector<uint8_t> symbols(max_symbol_bytes * seeds.size());
+
+    std::size_t size = 0;
+    {
+        pybind11::gil_scoped_release release;
+
+        for (std::size_t i = 0; i < seeds.size(); ++i)
+        {
+            generator.set_seed(seeds[i]);
+            generator.generate(coefficients.data() + i * coefficients_bytes,
+                               range);
+        }
+
+        for (std::size_t i = 0; i < seeds.size(); ++i)
+        {
+            size = encoder.encode_symbol(
+                symbols.data() + i * max_symbol_bytes, range,
+                coefficients.data() + i * coefficients_bytes);
+        }
+    }
+
+    pybind11::list repairs;
+    for (std::size_t i = 0; i < seeds.size(); ++i)
+    {
+        repairs.append(pybind11::bytearray{
+            (char*)symbols.data() + i * max_symbol_bytes, size});
+    }
+    return repairs;
+}
+
 auto slide_encoder_encode_systematic_symbol(encoder_type& encoder,
                                             std::size_t index)
     -> pybind11::bytearray
@@ -186,7 +395,12 @@ auto slide_encoder_encode_systematic_symbol(encoder_type& encoder,
     }
 
     std::vector<uint8_t> symbol(encoder.symbol_bytes(index));
-    auto size = encoder.encode_systematic_symbol(symbol.data(), index);
+
+    std::size_t size;
+    {
+        pybind11::gil_scoped_release release;
+        size = encoder.encode_systematic_symbol(symbol.data(), index);
+    }
 
     return pybind11::bytearray{(char*)symbol.data(), size};
 }
@@ -200,13 +414,28 @@ void encoder(pybind11::module& m)
              "The sliding window encoder constructor\n\n"
              "\t:param field: the chosen finite field.\n")
         .def("configure", &slide_encoder_configure, arg("max_symbol_bytes"),
+             arg("capacity") = 128,
              "Configures the encoder with the given parameters. This must"
              "be called before anything else. If needed configure can be"
              "called again. This is useful for reusing an existing coder."
              "Note that the a reconfiguration always implies a reset,"
              "so the coder will be in a clean state after the operation\n\n"
-             "\t:param max_symbol_bytes: The size of a symbol in bytes.\n")
+             "\t:param max_symbol_bytes: The size of a symbol in bytes.\n"
+             "\t:param capacity: The number of symbols the encoder keeps "
+             "memory for. Symbols pushed while more than capacity symbols are "
+             "in the stream are allocated individually.\n")
         .def("reset", &slide_encoder_reset, "Reset the state of the encoder.\n")
+        .def_property_readonly(
+            "capacity",
+            [](const encoder_type& encoder)
+            { return encoder.m_arena->capacity(); },
+            "Return the number of symbols the encoder keeps memory for.\n")
+        .def_property_readonly(
+            "heap_allocations",
+            [](const encoder_type& encoder)
+            { return encoder.m_arena->heap_allocations(); },
+            "Return the number of symbols allocated individually as more "
+            "than capacity symbols were in the stream.\n")
         .def_property_readonly("field", &encoder_type::field,
                                "Return the finite field used.\n")
         .def_property_readonly(
@@ -232,7 +461,7 @@ void encoder(pybind11::module& m)
                                &encoder_type::stream_upper_bound,
                                "Return the upper bound of the stream.\n")
         .def_property_readonly("stream_range", &slide_encoder_stream_range,
-                               "Return a tuple containing the lower- and upper "
+                               "Return a Range containing the lower- and upper "
                                "bound of the stream.\n")
         .def("in_stream", &encoder_type::in_stream, arg("index"),
              "Return True if the stream contains a symbol with the given "
@@ -248,6 +477,26 @@ void encoder(pybind11::module& m)
              "Encoder.stream_upper_bound\n\n"
              ":param symbol: The buffer containing all the data for the symbol"
              "Return the stream index of the symbol being added.\n")
+        .def("push_symbols", &slide_encoder_push_symbols, arg("symbols"),
+             arg("lengths"),
+             "Adds a batch of symbols stored back to back in one buffer to "
+             "the front of the encoder. This is the same as calling "
+             "push_symbol() for each symbol, but in a single call.\n\n"
+             ":param symbols: The buffer containing the data of all the "
+             "symbols.\n"
+             ":param lengths: A sequence with the size of each symbol in "
+             "bytes. The sizes must add up to the size of symbols.\n"
+             "Return a Range with the stream indices of the symbols added.\n")
+        .def("apply_feedback", &slide_encoder_apply_feedback,
+             arg("feedback"),
+             "Pop the symbols the decoder no longer needs, as reported by "
+             "Decoder.feedback(). This moves Encoder.stream_lower_bound "
+             "forward, so later coding windows taken from "
+             "Encoder.stream_range are smaller. Stale feedback is "
+             "harmless.\n\n"
+             ":param feedback: The feedback from the decoder.\n"
+             "Return the number of symbols in the stream which the decoder "
+             "has not yet seen, i.e. the repair symbols it needs.\n")
         .def("pop_symbol", &slide_encoder_pop_symbol,
              "Remove the \"oldest\" symbol from the stream. Increments the"
              "Encoder.stream_lower_bound\n\n"
@@ -257,11 +506,26 @@ void encoder(pybind11::module& m)
             arg("coefficients"),
             "Return an encoded symbol according to the coding coefficients and "
             "window.\n\n"
+            ":param window: A Range, or a tuple of two integers, with the "
+            "lower and upper bound of the symbols to encode.\n"
             ":param coefficients: The coding coefficients. These must have the"
             "\tmemory layout required (see README.rst). A compatible format can"
             "\tbe created using Encoder.generate()."
             "Return The size of the output symbol in bytes i.e the number of"
             "\tbytes used from the symbol buffer.\n")
+        .def("encode_repairs", &slide_encoder_encode_repairs,
+             arg("generator"), arg("window"), arg("seeds"),
+             "Return a list of repair symbols over the same window, one for "
+             "each seed. This is the same as calling generator.set_seed(), "
+             "generator.generate() and encode_symbol() for each seed, but in "
+             "a single call without the GIL.\n\n"
+             ":param generator: A generator.RandomUniform with the field of "
+             "the encoder. Its seed is changed by the call.\n"
+             ":param window: A Range, or a tuple of two integers, within the "
+             "stream.\n"
+             ":param seeds: A sequence of seeds, the decoder needs the seed "
+             "and window of each repair symbol to generate its "
+             "coefficients.\n")
         .def("encode_systematic_symbol",
              &slide_encoder_encode_systematic_symbol, arg("index"),
              "Return a source symbol bytearray.\n\n"
@@ -271,6 +535,15 @@ void encoder(pybind11::module& m)
         .def("symbol_data", &slide_encoder_symbol_data, arg("index"),
              "Get a symbol from the stream.\n\n"
              ":param index: The index of the symbol to get.")
+        .def("symbol_view", &slide_encoder_symbol_view, arg("index"),
+             "Get a read-only memoryview of a symbol in the stream. "
+             "Unlike symbol_data no copy is made. The memory of the symbol "
+             "is not reused while the view exists, also after the symbol is "
+             "popped from the stream.\n\n"
+             ":param index: The index of the symbol to get.")
+        .def("symbols_view", &slide_encoder_symbols_view,
+             "Get a list of read-only memoryviews of the symbols in the "
+             "stream, ordered by index from stream_lower_bound.\n")
         .def("in_stream", &slide_encoder_in_stream, arg("index"),
              "Check if a symbol is contained in the stream.\n\n"
              ":param index: The index of the symbol to check.")
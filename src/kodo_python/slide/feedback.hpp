@@ -0,0 +1,128 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+/// The feedback of the Decoder to the Encoder is laid out as:
+///
+///   varint lower_bound | varint symbols | decoded bitmap | pivot bitmap
+///
+/// where the varints are unsigned LEB128. The lower_bound is the first
+/// symbol the decoder still needs, all symbols before it are decoded or
+/// have left the decoder's stream. The bitmaps hold one bit per symbol in
+/// [lower_bound, lower_bound + symbols), the least significant bit first.
+namespace feedback
+{
+struct message
+{
+    uint64_t lower_bound = 0;
+    uint64_t symbols = 0;
+    const uint8_t* decoded = nullptr;
+    const uint8_t* pivot = nullptr;
+};
+
+/// @return The size of a bitmap in bytes
+inline uint64_t bitmap_bytes(uint64_t symbols)
+{
+    return (symbols + 7) / 8;
+}
+
+inline void write_varint(std::vector<uint8_t>& data, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        data.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    data.push_back(static_cast<uint8_t>(value));
+}
+
+/// @return False if the data ends before the varint or it is too long
+inline bool read_varint(const uint8_t*& data, const uint8_t* end,
+                        uint64_t& value)
+{
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        if (data == end)
+        {
+            return false;
+        }
+        uint8_t byte = *data++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void set_bit(uint8_t* bitmap, uint64_t index)
+{
+    bitmap[index / 8] |= static_cast<uint8_t>(1U << (index % 8));
+}
+
+inline bool is_set(const uint8_t* bitmap, uint64_t index)
+{
+    return (bitmap[index / 8] >> (index % 8)) & 1U;
+}
+
+/// @return False if the data is not a complete message
+inline bool parse(const uint8_t* data, std::size_t size, message& feedback)
+{
+    const uint8_t* end = data + size;
+    if (!read_varint(data, end, feedback.lower_bound) ||
+        !read_varint(data, end, feedback.symbols))
+    {
+        return false;
+    }
+
+    auto available = static_cast<uint64_t>(end - data);
+    if (feedback.symbols > available * 8)
+    {
+        return false;
+    }
+
+    uint64_t bytes = bitmap_bytes(feedback.symbols);
+    if (available != 2 * bytes)
+    {
+        return false;
+    }
+
+    feedback.decoded = data;
+    feedback.pivot = data + bytes;
+    return true;
+}
+}
+}
+}
+}
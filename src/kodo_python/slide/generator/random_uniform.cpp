@@ -41,17 +41,6 @@ namespace slide
 {
 namespace generator
 {
-struct random_uniform_wrapper : kodo::slide::generator::random_uniform
-{
-    random_uniform_wrapper(kodo::finite_field field) :
-        kodo::slide::generator::random_uniform(field)
-    {
-    }
-    std::function<void(const std::string&, const std::string&)> m_log_callback;
-};
-
-using random_uniform_type = random_uniform_wrapper;
-
 void slide_generator_random_uniform_enable_log(
     random_uniform_type& generator,
     std::function<void(const std::string&, const std::string&)> callback)
@@ -60,6 +49,7 @@ void slide_generator_random_uniform_enable_log(
     generator.enable_log(
         [](const std::string& name, const std::string& message, void* data)
         {
+            pybind11::gil_scoped_acquire acquire;
             random_uniform_type* generator =
                 static_cast<random_uniform_type*>(data);
             assert(generator->m_log_callback);
@@ -69,13 +59,16 @@ void slide_generator_random_uniform_enable_log(
 }
 
 auto slide_generator_random_uniform_generate(random_uniform_type& generator,
-                                             pybind11::tuple range_tuple)
+                                             pybind11::object window)
     -> pybind11::bytearray
 {
-    auto range = py_tuple_to_range(range_tuple);
+    auto range = py_window_to_range(window);
 
     std::vector<uint8_t> coefficients(generator.coefficients_bytes(range));
-    generator.generate(coefficients.data(), range);
+    {
+        pybind11::gil_scoped_release release;
+        generator.generate(coefficients.data(), range);
+    }
     return pybind11::bytearray{(char*)coefficients.data(), coefficients.size()};
 }
 
@@ -92,8 +85,8 @@ void random_uniform(pybind11::module& m)
         .def("generate", &slide_generator_random_uniform_generate,
              arg("window"),
              "Returns the coefficients.\n\n"
-             ":param window: A tuple of size 2 containing the lower_bound and "
-             "upper_bound of the coding window.\n")
+             ":param window: A Range, or a tuple of size 2, containing the "
+             "lower_bound and upper_bound of the coding window.\n")
         .def("set_seed", &random_uniform_type::set_seed, arg("seed"),
              "Sets the state of the coefficient generator. The coefficient "
              "generator will always produce the same set of coefficients for a "
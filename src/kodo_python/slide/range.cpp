@@ -0,0 +1,171 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "range.hpp"
+#include "tuple_to_range.hpp"
+
+#include "../version.hpp"
+
+#include <pybind11/pybind11.h>
+
+#include <kodo/slide/range.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+namespace
+{
+using range_type = kodo::slide::range;
+
+auto slide_range_init(uint64_t lower_bound, uint64_t upper_bound) -> range_type
+{
+    if (lower_bound > upper_bound)
+    {
+        throw pybind11::value_error(
+            "lower_bound: must be less than or equal to upper_bound");
+    }
+    return range_type(lower_bound, upper_bound);
+}
+
+auto slide_range_getitem(const range_type& range, int64_t index) -> uint64_t
+{
+    if (index < 0)
+    {
+        index += 2;
+    }
+
+    switch (index)
+    {
+    case 0:
+        return range.lower_bound();
+    case 1:
+        return range.upper_bound();
+    default:
+        throw pybind11::index_error("index: out of range");
+    }
+}
+
+auto slide_range_tuple(const range_type& range) -> pybind11::tuple
+{
+    return pybind11::make_tuple(range.lower_bound(), range.upper_bound());
+}
+
+auto slide_range_getitem_slice(const range_type& range,
+                               const pybind11::slice& slice) -> pybind11::tuple
+{
+    return slide_range_tuple(range).attr("__getitem__")(slice);
+}
+
+auto slide_range_add(const range_type& range, const pybind11::tuple& other)
+    -> pybind11::tuple
+{
+    return slide_range_tuple(range).attr("__add__")(other);
+}
+
+auto slide_range_radd(const range_type& range, const pybind11::tuple& other)
+    -> pybind11::tuple
+{
+    return other.attr("__add__")(slide_range_tuple(range));
+}
+
+bool slide_range_equal(const range_type& range, const range_type& other)
+{
+    return range.lower_bound() == other.lower_bound() &&
+           range.upper_bound() == other.upper_bound();
+}
+
+bool slide_range_equal_tuple(const range_type& range,
+                             const pybind11::tuple& other)
+{
+    return slide_range_tuple(range).equal(other);
+}
+
+auto slide_range_repr(const range_type& range) -> std::string
+{
+    return "Range(" + std::to_string(range.lower_bound()) + ", " +
+           std::to_string(range.upper_bound()) + ")";
+}
+}
+
+void range(pybind11::module& m)
+{
+    using namespace pybind11;
+    class_<range_type>(m, "Range",
+                       "A half-open range of symbol indices [lower_bound, "
+                       "upper_bound) used for the stream and coding windows. "
+                       "A Range behaves like the tuple (lower_bound, "
+                       "upper_bound): it can be unpacked, indexed, sliced, "
+                       "concatenated with tuples, hashed and pickled, but it "
+                       "is not an instance of tuple. The window arguments of "
+                       "the slide API also accept such a tuple, which is "
+                       "slower as it is converted on every call.")
+        .def(init(&slide_range_init), arg("lower_bound"), arg("upper_bound"),
+             "The Range constructor.\n\n"
+             ":param lower_bound: The first index in the range.\n"
+             ":param upper_bound: One past the last index in the range.\n")
+        .def(init(&py_tuple_to_range), arg("window"),
+             "Construct a Range from a tuple.\n\n"
+             ":param window: A tuple of size 2 containing the lower_bound and "
+             "upper_bound.\n")
+        .def_property_readonly("lower_bound", &range_type::lower_bound,
+                               "Return the first index in the range.\n")
+        .def_property_readonly("upper_bound", &range_type::upper_bound,
+                               "Return one past the last index in the "
+                               "range.\n")
+        .def_property_readonly(
+            "size",
+            [](const range_type& range)
+            { return range.upper_bound() - range.lower_bound(); },
+            "Return the number of indices in the range.\n")
+        .def("__len__", [](const range_type&) { return 2; })
+        .def("__getitem__", &slide_range_getitem, arg("index"))
+        .def("__getitem__", &slide_range_getitem_slice, arg("slice"))
+        .def("__add__", &slide_range_add, is_operator())
+        .def("__radd__", &slide_range_radd, is_operator())
+        .def("__iter__",
+             [](const range_type& range)
+             { return slide_range_tuple(range).attr("__iter__")(); })
+        .def("__eq__", &slide_range_equal, is_operator())
+        .def("__eq__", &slide_range_equal_tuple, is_operator())
+        .def("__ne__",
+             [](const range_type& range, const range_type& other)
+             { return !slide_range_equal(range, other); },
+             is_operator())
+        .def("__ne__",
+             [](const range_type& range, const pybind11::tuple& other)
+             { return !slide_range_equal_tuple(range, other); },
+             is_operator())
+        .def("__hash__",
+             [](const range_type& range)
+             { return pybind11::hash(slide_range_tuple(range)); })
+        .def("__repr__", &slide_range_repr)
+        .def(pickle(&slide_range_tuple,
+                    [](const pybind11::tuple& state)
+                    { return py_tuple_to_range(state); }));
+}
+}
+}
+}
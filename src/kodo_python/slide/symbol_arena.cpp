@@ -0,0 +1,106 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "symbol_arena.hpp"
+
+#include <cassert>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+void symbol_arena::configure(std::size_t max_symbol_bytes,
+                             std::size_t capacity)
+{
+    assert(m_count == 0);
+
+    m_max_symbol_bytes = max_symbol_bytes;
+    m_slot_bytes = (max_symbol_bytes + alignment - 1) / alignment * alignment;
+    m_memory.reset(new uint8_t[m_slot_bytes * capacity + alignment]);
+
+    auto address = reinterpret_cast<std::uintptr_t>(m_memory.get());
+    auto aligned = (address + alignment - 1) / alignment * alignment;
+    m_slots = m_memory.get() + (aligned - address);
+
+    m_used.assign(capacity, false);
+    m_head = 0;
+    m_count = 0;
+    m_heap_allocations = 0;
+}
+
+auto symbol_arena::allocate() -> uint8_t*
+{
+    if (m_count < m_used.size())
+    {
+        std::size_t index = (m_head + m_count) % m_used.size();
+        m_used[index] = true;
+        ++m_count;
+        return slot(index);
+    }
+
+    ++m_heap_allocations;
+    return new uint8_t[m_max_symbol_bytes];
+}
+
+void symbol_arena::release(const uint8_t* symbol)
+{
+    // Heap symbols are unrelated to the ring, so compare the addresses as
+    // integers rather than as pointers
+    auto address = reinterpret_cast<std::uintptr_t>(symbol);
+    auto begin = reinterpret_cast<std::uintptr_t>(m_slots);
+    auto end = begin + m_slot_bytes * m_used.size();
+
+    if (address < begin || address >= end)
+    {
+        delete[] symbol;
+        return;
+    }
+
+    std::size_t index = (address - begin) / m_slot_bytes;
+    assert(m_used[index]);
+    m_used[index] = false;
+
+    // Move past the released slots at the oldest end of the ring
+    while (m_count > 0 && !m_used[m_head])
+    {
+        m_head = (m_head + 1) % m_used.size();
+        --m_count;
+    }
+}
+
+auto symbol_arena::capacity() const -> std::size_t
+{
+    return m_used.size();
+}
+
+auto symbol_arena::heap_allocations() const -> std::size_t
+{
+    return m_heap_allocations;
+}
+
+auto symbol_arena::slot(std::size_t index) const -> uint8_t*
+{
+    return m_slots + index * m_slot_bytes;
+}
+}
+}
+}
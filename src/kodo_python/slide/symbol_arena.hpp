@@ -0,0 +1,89 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+/// Memory for the symbols of a stream. The symbols live in a ring of
+/// fixed-size, 64-byte aligned slots allocated once. As symbols are pushed
+/// to and popped from the stream in order, allocate and release just move
+/// the ends of the ring. When the ring is full symbols are allocated on
+/// the heap instead.
+class symbol_arena
+{
+public:
+    /// The alignment of the slots in bytes
+    static const std::size_t alignment = 64;
+
+    /// Allocate the ring, releasing the memory of any previous ring. All
+    /// symbols must have been released.
+    ///
+    /// @param max_symbol_bytes The maximum size of a symbol in bytes
+    /// @param capacity The number of slots in the ring
+    void configure(std::size_t max_symbol_bytes, std::size_t capacity);
+
+    /// @return Memory for a symbol of up to max_symbol_bytes bytes
+    auto allocate() -> uint8_t*;
+
+    /// Release the memory of a symbol
+    ///
+    /// @param symbol The memory returned by allocate
+    void release(const uint8_t* symbol);
+
+    /// @return The number of slots in the ring
+    auto capacity() const -> std::size_t;
+
+    /// @return The number of symbols allocated on the heap as the ring was
+    ///         full
+    auto heap_allocations() const -> std::size_t;
+
+private:
+    auto slot(std::size_t index) const -> uint8_t*;
+
+private:
+    std::unique_ptr<uint8_t[]> m_memory;
+    uint8_t* m_slots = nullptr;
+    std::size_t m_slot_bytes = 0;
+    std::size_t m_max_symbol_bytes = 0;
+
+    /// Whether the slot is in use, slots may be released out of order
+    std::vector<bool> m_used;
+
+    /// The oldest slot in use and the number of slots between it and the
+    /// next free slot
+    std::size_t m_head = 0;
+    std::size_t m_count = 0;
+
+    std::size_t m_heap_allocations = 0;
+};
+}
+}
+}
@@ -0,0 +1,94 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "symbol_exports.hpp"
+
+#include <cassert>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+auto symbol_exports::pin(const uint8_t* symbol) -> std::shared_ptr<void>
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pins[symbol].m_views++ == 0)
+        {
+            ++m_pinned;
+        }
+    }
+
+    auto exports = shared_from_this();
+    return std::shared_ptr<void>(
+        const_cast<uint8_t*>(symbol), [exports](void* symbol)
+        { exports->unpin(static_cast<const uint8_t*>(symbol)); });
+}
+
+void symbol_exports::collect()
+{
+    if (!m_has_released.load())
+    {
+        return;
+    }
+
+    std::vector<std::function<void()>> released;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        released.swap(m_released);
+        m_has_released = false;
+    }
+
+    for (auto& release : released)
+    {
+        release();
+    }
+}
+
+auto symbol_exports::is_exported() const -> bool
+{
+    return m_pinned.load() != 0;
+}
+
+void symbol_exports::unpin(const uint8_t* symbol)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto pin = m_pins.find(symbol);
+    assert(pin != m_pins.end());
+
+    if (--pin->second.m_views != 0)
+    {
+        return;
+    }
+
+    if (pin->second.m_release)
+    {
+        m_released.push_back(std::move(pin->second.m_release));
+        m_has_released = true;
+    }
+    m_pins.erase(pin);
+    --m_pinned;
+}
+}
+}
+}
@@ -0,0 +1,108 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+/// The symbols of a coder exported through memoryviews. A symbol which
+/// leaves the coder while it is exported is held back until its last view
+/// is released, so its memory is not reused under the view.
+///
+/// pin() and retire() are called by the thread using the coder. Views may
+/// be released by any thread, so the symbols they hand back are collected
+/// by the coder with collect().
+class symbol_exports : public std::enable_shared_from_this<symbol_exports>
+{
+public:
+    /// Export a symbol
+    ///
+    /// @param symbol The memory of the symbol
+    /// @return Holds the symbol back from reuse for as long as it exists
+    auto pin(const uint8_t* symbol) -> std::shared_ptr<void>;
+
+    /// Hand a symbol which left the coder back to the pool or arena it
+    /// came from, right away unless it is exported
+    ///
+    /// @param owner The pool or arena, it is kept alive while the symbol
+    ///        is held back
+    /// @param symbol The memory of the symbol or nullptr
+    template <class Owner>
+    void retire(const std::shared_ptr<Owner>& owner, const uint8_t* symbol)
+    {
+        if (m_pinned.load() != 0)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto pin = m_pins.find(symbol);
+            if (pin != m_pins.end())
+            {
+                pin->second.m_release = [owner, symbol]
+                { owner->release(symbol); };
+                return;
+            }
+        }
+        owner->release(symbol);
+    }
+
+    /// Hand back the retired symbols whose last view was released
+    void collect();
+
+    /// @return True if any symbol is exported
+    auto is_exported() const -> bool;
+
+private:
+    void unpin(const uint8_t* symbol);
+
+private:
+    struct pin_state
+    {
+        /// The number of views of the symbol
+        std::size_t m_views = 0;
+
+        /// Hands the symbol back once it is retired
+        std::function<void()> m_release;
+    };
+
+    std::mutex m_mutex;
+    std::unordered_map<const uint8_t*, pin_state> m_pins;
+
+    /// Retired symbols whose last view was released
+    std::vector<std::function<void()>> m_released;
+
+    std::atomic<std::size_t> m_pinned{0};
+    std::atomic<bool> m_has_released{false};
+};
+}
+}
+}
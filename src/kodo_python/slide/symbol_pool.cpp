@@ -0,0 +1,90 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "symbol_pool.hpp"
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+symbol_pool::~symbol_pool()
+{
+    clear();
+}
+
+void symbol_pool::configure(std::size_t symbol_bytes)
+{
+    if (symbol_bytes != m_symbol_bytes)
+    {
+        clear();
+        m_symbol_bytes = symbol_bytes;
+    }
+}
+
+auto symbol_pool::acquire() -> uint8_t*
+{
+    if (m_free.empty())
+    {
+        ++m_misses;
+        return new uint8_t[m_symbol_bytes];
+    }
+
+    ++m_hits;
+    uint8_t* symbol = m_free.back();
+    m_free.pop_back();
+    return symbol;
+}
+
+void symbol_pool::release(const uint8_t* symbol)
+{
+    if (symbol != nullptr)
+    {
+        m_free.push_back(const_cast<uint8_t*>(symbol));
+    }
+}
+
+auto symbol_pool::hits() const -> std::size_t
+{
+    return m_hits;
+}
+
+auto symbol_pool::misses() const -> std::size_t
+{
+    return m_misses;
+}
+
+auto symbol_pool::free_symbols() const -> std::size_t
+{
+    return m_free.size();
+}
+
+void symbol_pool::clear()
+{
+    for (uint8_t* symbol : m_free)
+    {
+        delete[] symbol;
+    }
+    m_free.clear();
+}
+}
+}
+}
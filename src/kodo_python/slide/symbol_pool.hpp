@@ -0,0 +1,80 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "../version.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace slide
+{
+/// A free list of symbol buffers. Buffers handed back by the decoder are
+/// kept for reuse, so in steady state decoding does not allocate.
+class symbol_pool
+{
+public:
+    symbol_pool() = default;
+
+    symbol_pool(const symbol_pool&) = delete;
+    symbol_pool& operator=(const symbol_pool&) = delete;
+
+    ~symbol_pool();
+
+    /// Set the size of the buffers, releasing the free buffers if it
+    /// changes
+    ///
+    /// @param symbol_bytes The size of a buffer in bytes
+    void configure(std::size_t symbol_bytes);
+
+    /// @return A buffer of symbol_bytes bytes, reused if one is free
+    auto acquire() -> uint8_t*;
+
+    /// Put a buffer back on the free list
+    ///
+    /// @param symbol A buffer returned by acquire or nullptr
+    void release(const uint8_t* symbol);
+
+    /// @return The number of calls to acquire served from the free list
+    auto hits() const -> std::size_t;
+
+    /// @return The number of calls to acquire which allocated a buffer
+    auto misses() const -> std::size_t;
+
+    /// @return The number of buffers on the free list
+    auto free_symbols() const -> std::size_t;
+
+private:
+    void clear();
+
+private:
+    std::size_t m_symbol_bytes = 0;
+    std::vector<uint8_t*> m_free;
+    std::size_t m_hits = 0;
+    std::size_t m_misses = 0;
+};
+}
+}
+}
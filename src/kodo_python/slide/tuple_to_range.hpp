@@ -61,6 +61,23 @@ inline kodo::slide::range py_tuple_to_range(const pybind11::tuple& tuple)
     return range;
 }
 
+/// Convert a window argument to a range. A kodo.slide.Range is used as is,
+/// only tuples are inspected and converted.
+inline kodo::slide::range py_window_to_range(const pybind11::handle& window)
+{
+    if (pybind11::isinstance<kodo::slide::range>(window))
+    {
+        return window.cast<const kodo::slide::range&>();
+    }
+    if (!pybind11::isinstance<pybind11::tuple>(window))
+    {
+        throw pybind11::type_error(
+            "window: Expected a kodo.slide.Range or a tuple");
+    }
+    auto tuple = pybind11::reinterpret_borrow<pybind11::tuple>(window);
+    return py_tuple_to_range(tuple);
+}
+
 }
 }
 }
@@ -0,0 +1,143 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+thread_pool::thread_pool(std::size_t threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    for (std::size_t i = 1; i < threads; ++i)
+    {
+        m_workers.emplace_back([this] { worker(); });
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_ready.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+std::size_t thread_pool::threads() const
+{
+    return m_workers.size() + 1;
+}
+
+void thread_pool::parallel_for(std::size_t count,
+                               const std::function<void(std::size_t)>& task)
+{
+    std::lock_guard<std::mutex> call_lock(m_call_mutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    assert(m_task == nullptr);
+    m_task = &task;
+    m_count = count;
+    m_next = 0;
+    m_error = nullptr;
+    m_work_ready.notify_all();
+
+    work(lock);
+    m_work_done.wait(lock, [this] { return m_running == 0; });
+
+    m_task = nullptr;
+    auto error = m_error;
+    m_error = nullptr;
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void thread_pool::worker()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_work_ready.wait(lock, [this]
+                          { return m_stop || (m_task && m_next < m_count); });
+
+        if (m_stop)
+        {
+            return;
+        }
+
+        work(lock);
+    }
+}
+
+void thread_pool::work(std::unique_lock<std::mutex>& lock)
+{
+    while (m_task != nullptr && m_next < m_count)
+    {
+        auto index = m_next++;
+        auto task = m_task;
+        ++m_running;
+
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            (*task)(index);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        if (error)
+        {
+            if (!m_error)
+            {
+                m_error = error;
+            }
+            // Skip the remaining iterations
+            m_next = m_count;
+        }
+
+        if (--m_running == 0 && m_next == m_count)
+        {
+            m_work_done.notify_all();
+        }
+    }
+}
+}
+}
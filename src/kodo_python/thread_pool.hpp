@@ -0,0 +1,84 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "version.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+/// A fixed set of worker threads running the iterations of a loop. The
+/// calling thread takes part in the work, so a pool with one thread runs
+/// everything on the caller.
+class thread_pool
+{
+public:
+    /// @param threads The number of threads including the calling thread,
+    ///        zero selects the number of hardware threads
+    explicit thread_pool(std::size_t threads);
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool();
+
+    /// @return The number of threads including the calling thread
+    std::size_t threads() const;
+
+    /// Call task(i) for every i in [0, count) and wait for all calls to
+    /// return. If a task throws, the remaining iterations are skipped and
+    /// the first exception is rethrown.
+    void parallel_for(std::size_t count,
+                      const std::function<void(std::size_t)>& task);
+
+private:
+    void worker();
+
+    void work(std::unique_lock<std::mutex>& lock);
+
+private:
+    std::vector<std::thread> m_workers;
+
+    /// Serializes parallel_for calls from different threads
+    std::mutex m_call_mutex;
+
+    std::mutex m_mutex;
+    std::condition_variable m_work_ready;
+    std::condition_variable m_work_done;
+
+    const std::function<void(std::size_t)>* m_task = nullptr;
+    std::size_t m_count = 0;
+    std::size_t m_next = 0;
+    std::size_t m_running = 0;
+    std::exception_ptr m_error;
+    bool m_stop = false;
+};
+}
+}
@@ -0,0 +1,210 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+namespace
+{
+/// The pool and queue index of the current worker thread, tasks submitted
+/// by a worker go to its own queue
+thread_local const work_stealing_pool* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+}
+
+work_stealing_pool::work_stealing_pool(std::size_t threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        m_queues.emplace_back(new worker_queue());
+    }
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        m_workers.emplace_back([this, i] { worker(i); });
+    }
+}
+
+work_stealing_pool::~work_stealing_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+std::size_t work_stealing_pool::threads() const
+{
+    return m_workers.size();
+}
+
+void work_stealing_pool::submit(const void* key, task function)
+{
+    if (key != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(m_strand_mutex);
+        auto strand = m_strands.find(key);
+        if (strand != m_strands.end())
+        {
+            strand->second.push_back(std::move(function));
+            return;
+        }
+        m_strands.emplace(key, std::deque<task>());
+    }
+
+    schedule(
+        [this, key, function = std::move(function)]()
+        {
+            function();
+            finish(key);
+        });
+}
+
+void work_stealing_pool::schedule(task function)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::size_t index;
+        if (current_pool == this)
+        {
+            index = current_queue;
+        }
+        else
+        {
+            index = m_next_queue;
+            m_next_queue = (m_next_queue + 1) % m_queues.size();
+        }
+
+        auto& queue = *m_queues[index];
+        {
+            std::lock_guard<std::mutex> queue_lock(queue.m_mutex);
+            queue.m_tasks.push_back(std::move(function));
+        }
+        ++m_pending;
+    }
+    m_wake.notify_one();
+}
+
+void work_stealing_pool::finish(const void* key)
+{
+    if (key == nullptr)
+    {
+        return;
+    }
+
+    task next;
+    {
+        std::lock_guard<std::mutex> lock(m_strand_mutex);
+        auto strand = m_strands.find(key);
+        assert(strand != m_strands.end());
+
+        if (strand->second.empty())
+        {
+            m_strands.erase(strand);
+            return;
+        }
+        next = std::move(strand->second.front());
+        strand->second.pop_front();
+    }
+
+    schedule(
+        [this, key, next = std::move(next)]()
+        {
+            next();
+            finish(key);
+        });
+}
+
+auto work_stealing_pool::pop(std::size_t index, task& function) -> bool
+{
+    // Take the newest task of our own queue, its data is likely still in
+    // the cache
+    {
+        auto& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.m_mutex);
+        if (!queue.m_tasks.empty())
+        {
+            function = std::move(queue.m_tasks.back());
+            queue.m_tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another queue
+    for (std::size_t i = 1; i < m_queues.size(); ++i)
+    {
+        auto& queue = *m_queues[(index + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.m_mutex);
+        if (!queue.m_tasks.empty())
+        {
+            function = std::move(queue.m_tasks.front());
+            queue.m_tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void work_stealing_pool::worker(std::size_t index)
+{
+    current_pool = this;
+    current_queue = index;
+
+    while (true)
+    {
+        task function;
+        if (pop(index, function))
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_pending;
+            }
+            function();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [this] { return m_stop || m_pending > 0; });
+
+        if (m_stop && m_pending == 0)
+        {
+            return;
+        }
+    }
+}
+}
+}
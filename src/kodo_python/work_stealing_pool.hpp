@@ -0,0 +1,100 @@
+// License for Commercial Usage
+// Distributed under the "KODO EVALUATION LICENSE 1.3"
+//
+// Licensees holding a valid commercial license may use this project
+// in accordance with the standard license agreement terms provided
+// with the Software (see accompanying file LICENSE.rst or
+// https://www.steinwurf.com/license), unless otherwise different
+// terms and conditions are agreed in writing between Licensee and
+// Steinwurf ApS in which case the license will be regulated by that
+// separate written agreement.
+//
+// License for Non-Commercial Usage
+// Distributed under the "KODO RESEARCH LICENSE 1.2"
+//
+// Licensees holding a valid research license may use this project
+// in accordance with the license agreement terms provided with the
+// Software
+//
+// See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+#pragma once
+
+#include "version.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace kodo_python
+{
+inline namespace STEINWURF_KODO_PYTHON_VERSION
+{
+/// Runs tasks on a set of worker threads. Every worker has its own queue,
+/// idle workers steal tasks from the queues of the others.
+class work_stealing_pool
+{
+public:
+    using task = std::function<void()>;
+
+    /// @param threads The number of worker threads, zero selects the number
+    ///        of hardware threads
+    explicit work_stealing_pool(std::size_t threads);
+
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+    /// Runs the remaining tasks and joins the workers
+    ~work_stealing_pool();
+
+    /// @return The number of worker threads
+    std::size_t threads() const;
+
+    /// Run a task on the pool. The task must not throw.
+    ///
+    /// @param key Tasks with the same key run one at a time in the order
+    ///        they were submitted, e.g. the coder they use. No ordering is
+    ///        imposed for a nullptr key.
+    /// @param function The task to run
+    void submit(const void* key, task function);
+
+private:
+    struct worker_queue
+    {
+        std::mutex m_mutex;
+        std::deque<task> m_tasks;
+    };
+
+    void schedule(task function);
+
+    void finish(const void* key);
+
+    auto pop(std::size_t index, task& function) -> bool;
+
+    void worker(std::size_t index);
+
+private:
+    std::vector<std::unique_ptr<worker_queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+
+    /// The number of tasks in the worker queues
+    std::size_t m_pending = 0;
+    std::size_t m_next_queue = 0;
+    bool m_stop = false;
+
+    /// The tasks waiting for an earlier task with the same key to finish.
+    /// A key is present while one of its tasks is scheduled or running.
+    std::mutex m_strand_mutex;
+    std::unordered_map<const void*, std::deque<task>> m_strands;
+};
+}
+}
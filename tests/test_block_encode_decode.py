@@ -17,6 +17,7 @@
 # with the license agreement terms provided with the Software
 # See accompanying file LICENSE.rst or https://www.steinwurf.com/license
 
+import mmap
 import os
 import random
 
@@ -257,6 +258,374 @@ class TestBlockEncodeDecode(unittest.TestCase):
 
         self.assertEqual(data_in, data_out)
 
+    def test_block_encode_symbol_into(self):
+
+        field = kodo.FiniteField.binary8
+        symbol_bytes = 1400
+        symbols = 50
+
+        encoder = kodo.block.Encoder(field)
+        encoder.configure(symbols, symbol_bytes)
+
+        generator = kodo.block.generator.RandomUniform(field)
+        generator.configure(encoder.symbols)
+
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        # Write into a slice of a larger buffer, e.g. after a packet header
+        header_bytes = 8
+        packet = bytearray(header_bytes + encoder.symbol_bytes)
+        payload = memoryview(packet)[header_bytes:]
+
+        for index in range(symbols):
+            encoder.encode_systematic_symbol_into(payload, index)
+            self.assertEqual(encoder.encode_systematic_symbol(index), payload)
+            self.assertEqual(bytes(header_bytes), packet[:header_bytes])
+
+        for _ in range(symbols):
+            coefficients = generator.generate()
+            encoder.encode_symbol_into(payload, coefficients)
+            self.assertEqual(encoder.encode_symbol(coefficients), payload)
+
+        with self.assertRaises(ValueError):
+            encoder.encode_symbol_into(bytearray(symbol_bytes - 1), coefficients)
+
+        with self.assertRaises(BufferError):
+            encoder.encode_symbol_into(bytes(symbol_bytes), coefficients)
+
+        with self.assertRaises(ValueError):
+            encoder.encode_systematic_symbol_into(payload, symbols)
+
+    def test_block_encode_symbols(self):
+
+        field = kodo.FiniteField.binary8
+        symbol_bytes = 1400
+        symbols = 50
+        count = symbols + 10
+
+        encoder = kodo.block.Encoder(field)
+        encoder.configure(symbols, symbol_bytes)
+
+        decoder = kodo.block.Decoder(field)
+        decoder.configure(symbols, symbol_bytes)
+
+        generator = kodo.block.generator.RandomUniform(field)
+        generator.configure(encoder.symbols)
+        generator.set_seed(0)
+
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        coded, coefficients = encoder.encode_symbols(generator, count)
+        self.assertEqual(count * symbol_bytes, len(coded))
+        coefficients_bytes = len(coefficients) // count
+
+        # The batch must match what the per symbol API produces
+        generator.set_seed(0)
+        for i in range(count):
+            expected_coefficients = generator.generate()
+            self.assertEqual(
+                expected_coefficients,
+                coefficients[i * coefficients_bytes : (i + 1) * coefficients_bytes],
+            )
+            self.assertEqual(
+                encoder.encode_symbol(expected_coefficients),
+                coded[i * symbol_bytes : (i + 1) * symbol_bytes],
+            )
+
+        symbols_view = memoryview(coded)
+        coefficients_view = memoryview(coefficients)
+        for i in range(count):
+            if decoder.is_complete():
+                break
+            decoder.decode_symbol(
+                symbols_view[i * symbol_bytes : (i + 1) * symbol_bytes],
+                coefficients_view[
+                    i * coefficients_bytes : (i + 1) * coefficients_bytes
+                ],
+            )
+
+        self.assertTrue(decoder.is_complete())
+        self.assertEqual(data_in, data_out)
+
+        # Encode into preallocated buffers
+        coded_out = bytearray(count * symbol_bytes)
+        coefficients_out = bytearray(count * coefficients_bytes)
+        result = encoder.encode_symbols(generator, count, coded_out, coefficients_out)
+        self.assertIs(coded_out, result[0])
+        self.assertIs(coefficients_out, result[1])
+
+        with self.assertRaises(ValueError):
+            encoder.encode_symbols(generator, count, bytearray(symbol_bytes))
+
+        # The generator must use the encoder's field
+        binary = kodo.block.generator.RandomUniform(kodo.FiniteField.binary)
+        binary.configure(encoder.symbols)
+        with self.assertRaises(ValueError):
+            encoder.encode_symbols(binary, count)
+
+        tunable = kodo.block.generator.Tunable(field)
+        tunable.configure(encoder.symbols)
+        coded, coefficients = encoder.encode_symbols(tunable, count, 0.5)
+        self.assertEqual(count * symbol_bytes, len(coded))
+
+    def test_block_decode_symbols(self):
+
+        field = kodo.FiniteField.binary8
+        symbol_bytes = 1400
+        symbols = 50
+        count = symbols + 10
+
+        encoder = kodo.block.Encoder(field)
+        encoder.configure(symbols, symbol_bytes)
+
+        generator = kodo.block.generator.RandomUniform(field)
+        generator.configure(encoder.symbols)
+
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        coded, coefficients = encoder.encode_symbols(generator, count)
+        coefficients_bytes = len(coefficients) // count
+
+        # Flat buffers with back to back rows
+        decoder = kodo.block.Decoder(field)
+        decoder.configure(symbols, symbol_bytes)
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        innovative = decoder.decode_symbols(
+            bytearray(coded), bytearray(coefficients), count
+        )
+        self.assertTrue(decoder.is_complete())
+        self.assertEqual(symbols, innovative)
+        self.assertEqual(data_in, data_out)
+
+        # Two dimensional buffers with padded rows, e.g. a receive buffer
+        # where each slot has room for a larger datagram
+        slot_bytes = symbol_bytes + 100
+        slots = bytearray(count * slot_bytes)
+        for i in range(count):
+            slots[i * slot_bytes : i * slot_bytes + symbol_bytes] = coded[
+                i * symbol_bytes : (i + 1) * symbol_bytes
+            ]
+
+        decoder = kodo.block.Decoder(field)
+        decoder.configure(symbols, symbol_bytes)
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        innovative = decoder.decode_symbols(
+            memoryview(slots).cast("B", (count, slot_bytes)),
+            memoryview(bytearray(coefficients)).cast(
+                "B", (count, coefficients_bytes)
+            ),
+            count,
+        )
+        self.assertTrue(decoder.is_complete())
+        self.assertEqual(symbols, innovative)
+        self.assertEqual(data_in, data_out)
+
+        with self.assertRaises(ValueError):
+            decoder.decode_symbols(bytearray(coded), bytearray(coefficients), count + 1)
+
+    def test_block_symbols_storage_buffers(self):
+
+        field = kodo.FiniteField.binary8
+        symbol_bytes = 1400
+        symbols = 50
+
+        encoder = kodo.block.Encoder(field)
+        encoder.configure(symbols, symbol_bytes)
+
+        decoder = kodo.block.Decoder(field)
+        decoder.configure(symbols, symbol_bytes)
+
+        generator = kodo.block.generator.RandomUniform(field)
+        generator.configure(encoder.symbols)
+
+        # Read-only storage is fine for the encoder
+        data_in = bytes(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        # Decode straight into a memory map
+        data_out = mmap.mmap(-1, decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        while not decoder.is_complete():
+            coefficients = generator.generate()
+            symbol = encoder.encode_symbol(coefficients)
+            decoder.decode_symbol(symbol, coefficients)
+
+        self.assertEqual(data_in, data_out[:])
+
+        # The storage is pinned while it is used by the coder
+        storage = bytearray(decoder.block_bytes)
+        decoder.configure(symbols, symbol_bytes)
+        decoder.set_symbols_storage(storage)
+        with self.assertRaises(BufferError):
+            storage.extend(b"resize")
+
+        # Reconfiguring releases the storage again
+        decoder.configure(symbols, symbol_bytes)
+        storage.extend(b"resize")
+        data_out.close()
+
+        # Replaced storage is released, as is the storage on reset
+        first = bytearray(decoder.block_bytes)
+        second = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(first)
+        decoder.set_symbols_storage(second)
+        first.extend(b"resize")
+        decoder.reset()
+        second.extend(b"resize")
+
+        # Only the latest storage of a symbol index is pinned
+        first = bytearray(symbol_bytes)
+        second = bytearray(symbol_bytes)
+        decoder.set_symbol_storage(first, 0)
+        decoder.set_symbol_storage(second, 0)
+        first.extend(b"resize")
+        with self.assertRaises(BufferError):
+            second.extend(b"resize")
+        decoder.set_symbols_storage(bytearray(decoder.block_bytes))
+        second.extend(b"resize")
+
+        with self.assertRaises(ValueError):
+            decoder.set_symbols_storage(bytearray(decoder.block_bytes - 1))
+
+        with self.assertRaises(BufferError):
+            decoder.set_symbols_storage(bytes(decoder.block_bytes))
+
+    def test_block_symbol_view(self):
+
+        field = kodo.FiniteField.binary8
+        symbol_bytes = 160
+        symbols = 10
+
+        encoder = kodo.block.Encoder(field)
+        encoder.configure(symbols, symbol_bytes)
+
+        decoder = kodo.block.Decoder(field)
+        decoder.configure(symbols, symbol_bytes)
+
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        block = decoder.symbols_view()
+        self.assertEqual(decoder.block_bytes, len(block))
+        self.assertTrue(block.readonly)
+
+        view = decoder.symbol_view(3)
+        self.assertEqual(symbol_bytes, len(view))
+        self.assertEqual(bytes(symbol_bytes), view)
+
+        # The views follow the storage as symbols are decoded
+        for index in range(symbols):
+            symbol = encoder.encode_systematic_symbol(index)
+            decoder.decode_systematic_symbol(symbol, index)
+
+        self.assertTrue(decoder.is_complete())
+        self.assertEqual(data_in, block)
+        self.assertEqual(data_in[3 * symbol_bytes : 4 * symbol_bytes], view)
+
+        # Slices outlive the view they were taken from, and keep the decoder
+        # alive
+        tail = block[-symbol_bytes:]
+        del block, view, decoder
+        self.assertEqual(data_in[-symbol_bytes:], tail)
+
+        with self.assertRaises(TypeError):
+            tail[0] = 0
+
+        decoder = kodo.block.Decoder(field)
+        decoder.configure(symbols, symbol_bytes)
+        with self.assertRaises(ValueError):
+            decoder.symbol_view(symbols)
+
+        # The views keep the storage exported after a reconfigure
+        data_out = bytearray(data_in)
+        decoder.set_symbols_storage(data_out)
+        block = decoder.symbols_view()
+        view = decoder.symbol_view(3)
+        decoder.configure(symbols, symbol_bytes)
+        decoder.set_symbols_storage(bytearray(decoder.block_bytes))
+        with self.assertRaises(BufferError):
+            data_out.extend(b"resize")
+        self.assertEqual(data_in, block)
+        self.assertEqual(data_in[3 * symbol_bytes : 4 * symbol_bytes], view)
+        del block, view
+        data_out.extend(b"resize")
+
+        # Storage set symbol by symbol is not necessarily contiguous
+        for index in range(symbols):
+            decoder.set_symbol_storage(bytearray(symbol_bytes), index)
+        with self.assertRaises(ValueError):
+            decoder.symbols_view()
+
+    def test_block_encode_decode_with_seed(self):
+
+        field = kodo.FiniteField.binary8
+        symbol_bytes = 160
+        symbols = 20
+
+        encoder = kodo.block.Encoder(field)
+        encoder.configure(symbols, symbol_bytes)
+
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        generators = [
+            (kodo.block.generator.RandomUniform(field), ()),
+            (kodo.block.generator.Tunable(field), (0.5,)),
+        ]
+
+        for generator, args in generators:
+            with self.subTest(generator):
+                generator.configure(symbols)
+
+                decoder = kodo.block.Decoder(field)
+                decoder.configure(symbols, symbol_bytes)
+                data_out = bytearray(decoder.block_bytes)
+                decoder.set_symbols_storage(data_out)
+
+                # Same result as the three step encode
+                generator.set_seed(42)
+                coefficients = generator.generate(*args)
+                expected = encoder.encode_symbol(coefficients)
+                symbol = encoder.encode_symbol_with_seed(generator, 42, *args)
+                self.assertEqual(expected, symbol)
+
+                seed = 0
+                out = bytearray(symbol_bytes)
+                while not decoder.is_complete():
+                    symbol = encoder.encode_symbol_with_seed(
+                        generator, seed, *args, out
+                    )
+                    self.assertIs(out, symbol)
+                    decoder.decode_symbol_with_seed(generator, seed, *args, out)
+                    seed += 1
+
+                self.assertEqual(data_in, data_out)
+
+        with self.assertRaises(ValueError):
+            encoder.encode_symbol_with_seed(generator, 0, 0.5, bytearray(1))
+
+        # The generator must use the coder's field
+        binary = kodo.block.generator.RandomUniform(kodo.FiniteField.binary)
+        binary.configure(symbols)
+        with self.assertRaises(ValueError):
+            encoder.encode_symbol_with_seed(binary, 0)
+        with self.assertRaises(ValueError):
+            decoder.decode_symbol_with_seed(binary, 0, bytearray(symbol_bytes))
+
 
 if __name__ == "__main__":
     unittest.main()
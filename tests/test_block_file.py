@@ -0,0 +1,214 @@
+#!/usr/bin/env python
+# encoding: utf-8
+
+"""Tests encoding and decoding files split into generations"""
+
+# License for Commercial Usage
+# Distributed under the "KODO EVALUATION LICENSE 1.3"
+# Licensees holding a valid commercial license may use this project in
+# accordance with the standard license agreement terms provided with the
+# Software (see accompanying file LICENSE.rst or
+# https://www.steinwurf.com/license), unless otherwise different terms and
+# conditions are agreed in writing between Licensee and Steinwurf ApS in which
+# case the license will be regulated by that separate written agreement.
+# License for Non-Commercial Usage
+# Distributed under the "KODO RESEARCH LICENSE 1.2"
+# Licensees holding a valid research license may use this project in accordance
+# with the license agreement terms provided with the Software
+# See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+import os
+import struct
+import tempfile
+import threading
+import unittest
+
+import kodo
+
+CODED_INDEX = 0xFFFFFFFF
+
+
+class TestBlockFile(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.directory.cleanup()
+
+    def write_file(self, size):
+        path = os.path.join(self.directory.name, "input")
+        data = os.urandom(size)
+        with open(path, "wb") as f:
+            f.write(data)
+        return path, data
+
+    def test_file_encoder(self):
+
+        field = kodo.FiniteField.binary8
+        symbols = 16
+        symbol_bytes = 100
+        generation_bytes = symbols * symbol_bytes
+
+        # Three full generations and a partial one
+        path, data = self.write_file(3 * generation_bytes + 123)
+
+        encoder = kodo.block.FileEncoder(path, field, symbols, symbol_bytes, 4)
+        self.assertEqual(4, encoder.generations)
+        self.assertEqual(len(data), encoder.file_bytes)
+        self.assertEqual(4, encoder.threads)
+        self.assertEqual(
+            8 + encoder.coefficients_bytes + symbol_bytes, encoder.packet_bytes
+        )
+
+        decoders = []
+        for generation in range(encoder.generations):
+            decoder = kodo.block.Decoder(field)
+            decoder.configure(symbols, symbol_bytes)
+            decoder.set_symbols_storage(bytearray(decoder.block_bytes))
+            decoders.append(decoder)
+
+        # Skip the systematic packets of the first generations
+        encoder.encode_packets(symbols, generations=[0, 1])
+
+        count = 0
+        while not all(decoder.is_complete() for decoder in decoders):
+            count += 1
+            self.assertLess(count, 100)
+
+            packets = encoder.encode_packets(2)
+            self.assertEqual(
+                2 * encoder.generations * encoder.packet_bytes, len(packets)
+            )
+
+            for offset in range(0, len(packets), encoder.packet_bytes):
+                packet = packets[offset : offset + encoder.packet_bytes]
+                generation, index = struct.unpack_from("<II", packet)
+                coefficients = packet[8 : 8 + encoder.coefficients_bytes]
+                symbol = packet[8 + encoder.coefficients_bytes :]
+
+                if index == CODED_INDEX:
+                    decoders[generation].decode_symbol(symbol, coefficients)
+                else:
+                    self.assertGreaterEqual(generation, 2)
+                    decoders[generation].decode_systematic_symbol(symbol, index)
+
+        decoded = b"".join(bytes(decoder.symbols_view()) for decoder in decoders)
+        self.assertEqual(data, decoded[: len(data)])
+        self.assertEqual(bytes(len(decoded) - len(data)), decoded[len(data) :])
+
+        with self.assertRaises(ValueError):
+            encoder.encode_packets(1, generations=[0, 0])
+
+        with self.assertRaises(ValueError):
+            encoder.encode_packets(1, generations=[encoder.generations])
+
+        with self.assertRaises(ValueError):
+            encoder.encode_packets(1, packets=bytearray(1))
+
+        with self.assertRaises(FileNotFoundError):
+            kodo.block.FileEncoder(path + "missing", field, symbols, symbol_bytes)
+
+    def test_file_decoder(self):
+
+        field = kodo.FiniteField.binary8
+        symbols = 16
+        symbol_bytes = 100
+        generation_bytes = symbols * symbol_bytes
+
+        path, data = self.write_file(5 * generation_bytes + 7)
+        output = os.path.join(self.directory.name, "output")
+
+        encoder = kodo.block.FileEncoder(path, field, symbols, symbol_bytes)
+        decoder = kodo.block.FileDecoder(
+            output, field, symbols, symbol_bytes, len(data), 3
+        )
+        self.assertEqual(encoder.generations, decoder.generations)
+        self.assertEqual(encoder.packet_bytes, decoder.packet_bytes)
+        self.assertEqual(len(data), os.path.getsize(output))
+
+        # Lose every third packet
+        packet_bytes = encoder.packet_bytes
+        completed = []
+        count = 0
+        while not decoder.is_complete():
+            count += 1
+            self.assertLess(count, 100)
+
+            packets = encoder.encode_packets(4)
+            received = b"".join(
+                packets[offset : offset + packet_bytes]
+                for offset in range(0, len(packets), packet_bytes)
+                if (offset // packet_bytes) % 3 != 2
+            )
+            completed += decoder.decode_packets(received)
+
+        self.assertEqual(list(range(decoder.generations)), sorted(completed))
+        self.assertEqual(decoder.generations, decoder.completed_generations)
+        for generation in range(decoder.generations):
+            self.assertTrue(decoder.is_generation_complete(generation))
+            self.assertEqual(symbols, decoder.generation_rank(generation))
+
+        # Packets for decoded generations are ignored
+        self.assertEqual([], decoder.decode_packets(encoder.encode_packets(1)))
+
+        decoder.flush()
+        del decoder
+        with open(output, "rb") as f:
+            self.assertEqual(data, f.read())
+
+        decoder = kodo.block.FileDecoder(
+            output, field, symbols, symbol_bytes, len(data)
+        )
+        with self.assertRaises(ValueError):
+            decoder.decode_packets(bytes(packet_bytes - 1))
+
+        with self.assertRaises(ValueError):
+            packet = bytearray(packet_bytes)
+            struct.pack_into("<II", packet, 0, decoder.generations, 0)
+            decoder.decode_packets(packet)
+
+
+    def test_file_decoder_threads(self):
+
+        field = kodo.FiniteField.binary8
+        symbols = 16
+        symbol_bytes = 100
+        generation_bytes = symbols * symbol_bytes
+
+        path, data = self.write_file(8 * generation_bytes + 7)
+        output = os.path.join(self.directory.name, "output")
+
+        encoder = kodo.block.FileEncoder(path, field, symbols, symbol_bytes)
+        decoder = kodo.block.FileDecoder(
+            output, field, symbols, symbol_bytes, len(data), 2
+        )
+
+        batches = [encoder.encode_packets(2) for _ in range(20)]
+        completed = [[], []]
+
+        def decode(thread):
+            for batch in batches[thread::2]:
+                packets = bytearray(batch)
+                completed[thread] += decoder.decode_packets(packets)
+                # The decoder must not use the packets after the call
+                packets[:] = bytes(len(packets))
+
+        threads = [threading.Thread(target=decode, args=(i,)) for i in range(2)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        self.assertTrue(decoder.is_complete())
+        self.assertEqual(
+            list(range(decoder.generations)), sorted(completed[0] + completed[1])
+        )
+        self.assertEqual(decoder.generations, decoder.completed_generations)
+
+        decoder.flush()
+        del decoder
+        with open(output, "rb") as f:
+            self.assertEqual(data, f.read())
+
+if __name__ == "__main__":
+    unittest.main()
@@ -109,3 +109,46 @@ class TestFulcrumEncodeDecode(unittest.TestCase):
                     decoder.decode_symbol(symbol, coefficients)
 
         self.assertEqual(data_in, data_out)
+        self.assertEqual(data_in, decoder.symbols_view())
+        self.assertEqual(
+            data_in[:symbol_bytes], decoder.symbol_view(0).tobytes()
+        )
+
+    def test_fulcrum_encode_decode_with_seed(self):
+
+        field = kodo.FiniteField.binary8
+        symbol_bytes = 160
+        symbols = 20
+        expansion = 4
+
+        encoder = kodo.fulcrum.Encoder(field)
+        encoder.configure(symbols, symbol_bytes, expansion)
+
+        decoder = kodo.fulcrum.Decoder(field)
+        decoder.configure(symbols, symbol_bytes, expansion)
+
+        generator = kodo.fulcrum.generator.RandomUniform()
+        generator.configure(symbols, expansion)
+
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        seed = 0
+        while not decoder.is_complete():
+            self.assertLess(seed, symbols * 10)
+            symbol = encoder.encode_symbol_with_seed(generator, seed)
+            decoder.decode_symbol_with_seed(generator, seed, symbol)
+            seed += 1
+
+        self.assertEqual(data_in, data_out)
+
+        # The generator must cover the coefficients of all inner symbols
+        encoder.configure(symbols, symbol_bytes, expansion + 8)
+        decoder.configure(symbols, symbol_bytes, expansion + 8)
+        with self.assertRaises(ValueError):
+            encoder.encode_symbol_with_seed(generator, 0)
+        with self.assertRaises(ValueError):
+            decoder.decode_symbol_with_seed(generator, 0, bytearray(symbol_bytes))
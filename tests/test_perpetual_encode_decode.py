@@ -17,7 +17,9 @@
 # with the license agreement terms provided with the Software
 # See accompanying file LICENSE.rst or https://www.steinwurf.com/license
 
+import array
 import os
+import struct
 import unittest
 import kodo
 
@@ -78,6 +80,349 @@ class TestPerpetualEncodeDecode(unittest.TestCase):
 
         self.assertEqual(data_in, data_out)
 
+    def test_encode_symbols(self):
+
+        width = kodo.perpetual.Width._32
+        symbol_bytes = 100
+        block_bytes = 100000
+
+        encoder = kodo.perpetual.Encoder(width)
+        decoder = kodo.perpetual.Decoder(width)
+
+        encoder.configure(block_bytes, symbol_bytes)
+        decoder.configure(block_bytes, symbol_bytes)
+
+        generator = kodo.perpetual.generator.RandomUniform(width)
+        offset_generator = kodo.perpetual.offset.RandomUniform()
+        offset_generator.configure(encoder.symbols)
+        offset_generator.set_seed(0)
+
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        batch = 64
+        symbols = bytearray(batch * symbol_bytes)
+        seed = 0
+
+        while not decoder.is_complete():
+            seeds = list(range(seed, seed + batch))
+            seed += batch
+
+            out, offsets = encoder.encode_symbols(
+                generator, offset_generator, seeds, symbols
+            )
+            self.assertIs(out, symbols)
+            self.assertEqual(len(offsets), batch)
+
+            for i in range(batch):
+                symbol = symbols[i * symbol_bytes : (i + 1) * symbol_bytes]
+                coefficients = generator.generate(seeds[i])
+                decoder.decode_symbol(symbol, coefficients, offsets[i])
+
+        self.assertEqual(data_in, data_out)
+
+        # The same as encoding the symbols one by one
+        offset_generator.set_seed(1)
+        symbols, offsets = encoder.encode_symbols(
+            generator, offset_generator, [7, 8]
+        )
+        offset_generator.set_seed(1)
+        for i, seed in enumerate([7, 8]):
+            offset = offset_generator.offset()
+            self.assertEqual(offset, offsets[i])
+            symbol = encoder.encode_symbol(generator.generate(seed), offset)
+            self.assertEqual(
+                symbol, symbols[i * symbol_bytes : (i + 1) * symbol_bytes]
+            )
+
+        with self.assertRaises(ValueError):
+            encoder.encode_symbols(
+                generator, offset_generator, [1, 2], bytearray(symbol_bytes)
+            )
+
+    def test_packetizer(self):
+
+        width = kodo.perpetual.Width._16
+        symbol_bytes = 100
+        block_bytes = 50000
+
+        packetizer = kodo.perpetual.Packetizer(width, block_bytes, symbol_bytes)
+        self.assertEqual(packetizer.packet_bytes, 27 + symbol_bytes)
+
+        data_in = bytearray(os.urandom(block_bytes))
+        packetizer.set_symbols_storage(data_in)
+
+        # The header has the seed, offset and coder parameters
+        packet = packetizer.write_packet(seed=42)
+        seed, offset, width_value, header_block_bytes, header_symbol_bytes = (
+            struct.unpack_from("<QQBII", packet)
+        )
+        self.assertEqual(seed, 42)
+        self.assertLess(offset, packetizer.symbols)
+        self.assertEqual(width_value, width.value)
+        self.assertEqual(header_block_bytes, block_bytes)
+        self.assertEqual(header_symbol_bytes, symbol_bytes)
+
+        generator = kodo.perpetual.generator.RandomUniform(width)
+        encoder = kodo.perpetual.Encoder(width)
+        encoder.configure(block_bytes, symbol_bytes)
+        encoder.set_symbols_storage(data_in)
+        symbol = encoder.encode_symbol(generator.generate(42), offset)
+        self.assertEqual(packet[27:], symbol)
+
+        depacketizer = kodo.perpetual.Depacketizer()
+        self.assertIsNone(depacketizer.data)
+
+        packet = bytearray(packetizer.packet_bytes)
+        while not depacketizer.is_complete():
+            packetizer.write_packet(packet)
+            depacketizer.decode_packet(bytes(packet))
+
+        self.assertEqual(depacketizer.data, data_in)
+        self.assertEqual(depacketizer.rank, depacketizer.symbols)
+
+        with self.assertRaises(ValueError):
+            depacketizer.decode_packet(packet[:-1])
+
+    def test_depacketizer_reconfigure(self):
+
+        width = kodo.perpetual.Width._16
+        symbol_bytes = 100
+
+        first = kodo.perpetual.Packetizer(width, 20000, symbol_bytes)
+        first_data = bytearray(os.urandom(first.block_bytes))
+        first.set_symbols_storage(first_data)
+
+        second = kodo.perpetual.Packetizer(width, 30000, symbol_bytes)
+        second_data = bytearray(os.urandom(second.block_bytes))
+        second.set_symbols_storage(second_data)
+
+        depacketizer = kodo.perpetual.Depacketizer()
+        depacketizer.decode_packet(first.write_packet())
+        rank = depacketizer.rank
+        data = depacketizer.data
+
+        # A packet of another block does not replace the one being decoded
+        with self.assertRaises(ValueError):
+            depacketizer.decode_packet(second.write_packet())
+        self.assertEqual(depacketizer.rank, rank)
+        self.assertIs(depacketizer.data, data)
+        self.assertEqual(depacketizer.block_bytes, first.block_bytes)
+
+        while not depacketizer.is_complete():
+            depacketizer.decode_packet(first.write_packet())
+        self.assertEqual(depacketizer.data, first_data)
+
+        # After a reset the next packet configures the decoder
+        depacketizer.reset()
+        self.assertIsNone(depacketizer.data)
+        self.assertEqual(depacketizer.rank, 0)
+
+        while not depacketizer.is_complete():
+            depacketizer.decode_packet(second.write_packet())
+        self.assertEqual(depacketizer.block_bytes, second.block_bytes)
+        self.assertEqual(depacketizer.data, second_data)
+
+    def test_depacketizer_rejects_header(self):
+
+        width = kodo.perpetual.Width._16
+        symbol_bytes = 100
+        block_bytes = 20000
+
+        packetizer = kodo.perpetual.Packetizer(width, block_bytes, symbol_bytes)
+        packetizer.set_symbols_storage(bytearray(block_bytes))
+        packet = packetizer.write_packet()
+
+        def header(**fields):
+            values = dict(
+                zip(
+                    [
+                        "seed",
+                        "offset",
+                        "width",
+                        "block_bytes",
+                        "symbol_bytes",
+                        "outer_interval",
+                        "outer_segments",
+                    ],
+                    struct.unpack_from("<QQBIIBB", packet),
+                )
+            )
+            values.update(fields)
+            return struct.pack("<QQBIIBB", *values.values()) + packet[27:]
+
+        # The header is valid as written
+        depacketizer = kodo.perpetual.Depacketizer(max_block_bytes=block_bytes)
+        depacketizer.decode_packet(header())
+
+        for fields in [
+            dict(width=3),
+            dict(block_bytes=0),
+            dict(symbol_bytes=0),
+            dict(symbol_bytes=block_bytes + 1),
+            dict(block_bytes=block_bytes + 1),
+            dict(block_bytes=0xFFFFFFFF),
+            dict(outer_segments=0),
+        ]:
+            depacketizer = kodo.perpetual.Depacketizer(max_block_bytes=block_bytes)
+            with self.assertRaises(ValueError):
+                depacketizer.decode_packet(header(**fields))
+            self.assertIsNone(depacketizer.data)
+            self.assertEqual(depacketizer.symbols, 0)
+
+        with self.assertRaises(ValueError):
+            kodo.perpetual.Depacketizer(max_block_bytes=0)
+        with self.assertRaises(ValueError):
+            kodo.perpetual.Packetizer(width, 10, 100)
+
+    def test_bulk_generation(self):
+
+        width = kodo.perpetual.Width._64
+
+        offset_generator = kodo.perpetual.offset.RandomUniform()
+        offset_generator.configure(1000)
+
+        offset_generator.set_seed(5)
+        offsets = offset_generator.offsets(100)
+        self.assertEqual(len(offsets), 100)
+
+        offset_generator.set_seed(5)
+        expected = [offset_generator.offset() for _ in range(100)]
+        self.assertEqual(list(offsets), expected)
+
+        generator = kodo.perpetual.generator.RandomUniform(width)
+        seeds = list(range(1000, 1100))
+        expected = [generator.generate(seed) for seed in seeds]
+
+        self.assertEqual(list(generator.generate_many(seeds)), expected)
+
+        # Buffers of seeds and preallocated outputs
+        out = array.array("Q", bytes(8 * len(seeds)))
+        result = generator.generate_many(array.array("Q", seeds), out)
+        self.assertIs(result, out)
+        self.assertEqual(list(out), expected)
+
+        with self.assertRaises(ValueError):
+            generator.generate_many(seeds, array.array("Q", [0]))
+
+        # Buffers of other item types are not read as 64 bit seeds
+        with self.assertRaises(ValueError):
+            generator.generate_many(array.array("d", seeds))
+        with self.assertRaises(ValueError):
+            generator.generate_many(array.array("i", seeds + seeds))
+        with self.assertRaises(ValueError):
+            generator.generate_many(seeds, bytearray(8 * len(seeds)))
+        with self.assertRaises(ValueError):
+            offset_generator.offsets(2, array.array("d", [0, 0]))
+        with self.assertRaises(ValueError):
+            kodo.perpetual.offset.RandomUniform().offsets(1)
+
+
+    def test_prepare(self):
+
+        width = kodo.perpetual.Width._32
+        block_bytes = 20000
+        symbol_bytes = 100
+
+        encoder = kodo.perpetual.Encoder(width)
+        encoder.configure(block_bytes, symbol_bytes)
+
+        with self.assertRaises(ValueError):
+            encoder.prepare()
+
+        data_in = bytearray(os.urandom(block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        timings = encoder.prepare(threads=2)
+        self.assertEqual(timings["threads"], 2)
+        for phase in ["prefault", "outer_symbols", "total"]:
+            self.assertGreaterEqual(timings[phase], 0.0)
+        self.assertGreaterEqual(timings["total"], timings["outer_symbols"])
+
+        # The prepared encoder still produces decodable symbols
+        decoder = kodo.perpetual.Decoder(width)
+        decoder.configure(block_bytes, symbol_bytes)
+        data_out = bytearray(block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        generator = kodo.perpetual.generator.RandomUniform(width)
+        offset_generator = kodo.perpetual.offset.RandomUniform()
+        offset_generator.configure(encoder.symbols)
+
+        seed = 0
+        while not decoder.is_complete():
+            coefficients = generator.generate(seed)
+            offset = offset_generator.offset()
+            symbol = encoder.encode_symbol(coefficients, offset)
+            decoder.decode_symbol(symbol, coefficients, offset)
+            seed += 1
+
+        self.assertEqual(data_out, data_in)
+
+    def test_decoder_stats(self):
+
+        width = kodo.perpetual.Width._32
+        block_bytes = 20000
+        symbol_bytes = 100
+
+        encoder = kodo.perpetual.Encoder(width)
+        encoder.configure(block_bytes, symbol_bytes)
+        decoder = kodo.perpetual.Decoder(width)
+        decoder.configure(block_bytes, symbol_bytes)
+
+        stats = decoder.stats()
+        self.assertEqual(stats["symbols_received"], 0)
+        self.assertIsNone(stats["mapping_rank"])
+
+        data_in = bytearray(os.urandom(block_bytes))
+        encoder.set_symbols_storage(data_in)
+        data_out = bytearray(block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        generator = kodo.perpetual.generator.RandomUniform(width)
+        offset_generator = kodo.perpetual.offset.RandomUniform()
+        offset_generator.configure(encoder.symbols)
+
+        # The same symbol twice is redundant the second time
+        coefficients = generator.generate(1)
+        offset = offset_generator.offset()
+        for _ in range(2):
+            symbol = encoder.encode_symbol(coefficients, offset)
+            decoder.decode_symbol(symbol, coefficients, offset)
+
+        stats = decoder.stats()
+        self.assertEqual(stats["symbols_received"], 2)
+        self.assertEqual(stats["redundant_symbols"], 1)
+        self.assertEqual(stats["innovative_symbols"], 1)
+
+        received = 2
+        seed = 2
+        while not decoder.is_complete():
+            coefficients = generator.generate(seed)
+            offset = offset_generator.offset()
+            symbol = encoder.encode_symbol(coefficients, offset)
+            decoder.decode_symbol(symbol, coefficients, offset)
+            received += 1
+            seed += 1
+
+        self.assertEqual(data_out, data_in)
+
+        stats = decoder.stats()
+        self.assertEqual(stats["symbols_received"], received)
+        self.assertEqual(
+            stats["innovative_symbols"] + stats["redundant_symbols"], received
+        )
+        self.assertEqual(stats["rank"], decoder.rank)
+        self.assertIsNotNone(stats["mapping_rank"])
+        self.assertLessEqual(stats["mapping_received"], received)
+        for phase in ["inner_seconds", "mapping_seconds", "completion_seconds"]:
+            self.assertGreaterEqual(stats[phase], 0.0)
+
+        decoder.reset()
+        self.assertEqual(decoder.stats()["symbols_received"], 0)
 
 if __name__ == "__main__":
     unittest.main()
@@ -18,7 +18,9 @@
 # See accompanying file LICENSE.rst or https://www.steinwurf.com/license
 
 import os
+import pickle
 import random
+import time
 
 import unittest
 import kodo
@@ -105,6 +107,605 @@ class TestSlideEncodeDecode(unittest.TestCase):
 
             iterations += 1
 
+    def test_slide_symbol_view(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 100
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+
+        decoder = kodo.slide.Decoder(field)
+        decoder.configure(max_symbol_bytes)
+
+        symbols = [bytearray(os.urandom(10 * (i + 1))) for i in range(5)]
+        for symbol in symbols:
+            encoder.push_symbol(symbol)
+            decoder.push_symbol()
+
+        views = encoder.symbols_view()
+        self.assertEqual(len(symbols), len(views))
+        for symbol, view in zip(symbols, views):
+            self.assertEqual(symbol, view)
+            self.assertTrue(view.readonly)
+
+        self.assertEqual(symbols[2], encoder.symbol_view(2))
+        with self.assertRaises(ValueError):
+            encoder.symbol_view(len(symbols))
+
+        for index in range(len(symbols)):
+            symbol = encoder.encode_systematic_symbol(index)
+            decoder.decode_systematic_symbol(symbol, index)
+
+        for symbol, view in zip(symbols, decoder.symbols_view()):
+            self.assertEqual(symbol, view)
+
+        self.assertIsNone(decoder.symbol_view(len(symbols)))
+
+    def test_slide_symbol_view_after_pop(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 100
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes, capacity=4)
+
+        decoder = kodo.slide.Decoder(field)
+        decoder.configure(max_symbol_bytes, capacity=4)
+
+        def send():
+            encoder.push_symbol(os.urandom(max_symbol_bytes))
+            index = encoder.stream_upper_bound - 1
+            decoder.advance_to(index + 1)
+            symbol = encoder.encode_systematic_symbol(index)
+            decoder.decode_systematic_symbol(symbol, index)
+
+        send()
+        encoder_view = encoder.symbol_view(0)
+        decoder_view = decoder.symbol_view(0)
+        encoder_tail = encoder.symbols_view()[0][-10:]
+        delivered = decoder.deliver_symbols()
+        expected = bytes(encoder_view)
+        self.assertEqual(expected, decoder_view)
+
+        # The memory of popped symbols is not reused while views of them
+        # exist
+        encoder.pop_symbol()
+        for _ in range(20):
+            send()
+            encoder.pop_symbol()
+        self.assertEqual(decoder.stream_lower_bound, 17)
+
+        self.assertEqual(expected, encoder_view)
+        self.assertEqual(expected, decoder_view)
+        self.assertEqual(expected[-10:], encoder_tail)
+        self.assertEqual(expected, delivered[0][1])
+
+        # Also not after the coders are reset or reconfigured
+        encoder.reset()
+        decoder.configure(max_symbol_bytes // 2, capacity=4)
+        encoder.configure(max_symbol_bytes // 2, capacity=4)
+        for _ in range(2):
+            encoder.push_symbol(os.urandom(max_symbol_bytes // 2))
+            index = encoder.stream_upper_bound - 1
+            decoder.advance_to(index + 1)
+            decoder.decode_systematic_symbol(
+                encoder.encode_systematic_symbol(index), index
+            )
+        self.assertEqual(expected, encoder_view)
+        self.assertEqual(expected, decoder_view)
+
+        # Once released the memory is reused again
+        del encoder_view, decoder_view, encoder_tail, delivered
+        for _ in range(10):
+            encoder.pop_symbol()
+            encoder.push_symbol(os.urandom(max_symbol_bytes // 2))
+        self.assertEqual(0, encoder.heap_allocations)
+
+    def test_slide_encoder_capacity(self):
+
+        encoder = kodo.slide.Encoder(kodo.FiniteField.binary8)
+        encoder.configure(100, capacity=4)
+        self.assertEqual(4, encoder.capacity)
+
+        symbols = {}
+        for index in range(4):
+            symbols[index] = os.urandom(100 - index)
+            encoder.push_symbol(symbols[index])
+        self.assertEqual(0, encoder.heap_allocations)
+
+        # The stream may grow beyond the capacity
+        symbols[4] = os.urandom(50)
+        encoder.push_symbol(symbols[4])
+        self.assertEqual(1, encoder.heap_allocations)
+
+        # Popping frees memory for new symbols, with at most capacity symbols
+        # in the stream no more allocations are needed
+        encoder.pop_symbol()
+        for _ in range(1000):
+            encoder.pop_symbol()
+            index = encoder.stream_upper_bound
+            symbols[index] = os.urandom(1 + index % 100)
+            encoder.push_symbol(symbols[index])
+
+        self.assertEqual(1, encoder.heap_allocations)
+        for index in range(encoder.stream_lower_bound, encoder.stream_upper_bound):
+            self.assertEqual(symbols[index], encoder.symbol_view(index))
+
+        with self.assertRaises(ValueError):
+            encoder.push_symbol(bytes(101))
+
+        encoder.reset()
+        encoder.configure(100)
+        self.assertEqual(128, encoder.capacity)
+
+    def test_slide_decoder_pool(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 100
+        window_symbols = 8
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+
+        decoder = kodo.slide.Decoder(field)
+        decoder.configure(max_symbol_bytes)
+
+        generator = kodo.slide.generator.RandomUniform(field)
+
+        misses = []
+        for iteration in range(400):
+            if encoder.stream_symbols == window_symbols:
+                encoder.pop_symbol()
+            encoder.push_symbol(os.urandom(max_symbol_bytes))
+
+            while decoder.stream_upper_bound < encoder.stream_upper_bound:
+                if decoder.stream_symbols == window_symbols:
+                    decoder.pop_symbol()
+                decoder.push_symbol()
+
+            index = encoder.stream_upper_bound - 1
+            if iteration % 4 == 0:
+                window = encoder.stream_range
+                generator.set_seed(iteration)
+                coefficients = generator.generate(window)
+                symbol = encoder.encode_symbol(window, coefficients)
+                decoder.decode_symbol(symbol, window, coefficients)
+            else:
+                symbol = encoder.encode_systematic_symbol(index)
+                decoder.decode_systematic_symbol(symbol, index)
+
+            misses.append(decoder.pool_misses)
+
+        # Once warmed up the buffers are recycled
+        self.assertEqual(misses[100], misses[-1])
+        self.assertGreater(decoder.pool_hits, 300)
+
+    def test_slide_decoder_advance_to(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 100
+
+        decoder = kodo.slide.Decoder(field)
+        decoder.configure(max_symbol_bytes)
+
+        # Without a capacity the decoder does not know how far to slide
+        with self.assertRaises(ValueError):
+            decoder.advance_to(4)
+
+        decoder.configure(max_symbol_bytes, capacity=8)
+
+        # Pushing up to the capacity
+        decoder.advance_to(5)
+        self.assertEqual(decoder.stream_range, (0, 5))
+        decoder.advance_to(10)
+        self.assertEqual(decoder.stream_range, (2, 10))
+
+        # Moving backwards does nothing
+        decoder.advance_to(3)
+        self.assertEqual(decoder.stream_range, (2, 10))
+
+        # A decoded symbol is recycled when it leaves the stream
+        symbol = bytearray(os.urandom(max_symbol_bytes))
+        decoder.decode_systematic_symbol(symbol, 9)
+        self.assertTrue(decoder.is_symbol_decoded(9))
+        decoder.advance_to(13)
+        self.assertEqual(decoder.stream_range, (5, 13))
+        self.assertEqual(decoder.symbol_data(9), symbol)
+
+        # A large jump moves the stream
+        decoder.advance_to(1000)
+        self.assertEqual(decoder.stream_range, (992, 1000))
+        self.assertEqual(decoder.symbols_missing, 8)
+
+        # The capacity can be given per call
+        decoder.advance_to(1010, capacity=4)
+        self.assertEqual(decoder.stream_range, (1006, 1010))
+
+    def test_slide_range(self):
+
+        window = kodo.slide.Range(3, 7)
+        self.assertEqual(window.lower_bound, 3)
+        self.assertEqual(window.upper_bound, 7)
+        self.assertEqual(window.size, 4)
+
+        # A Range behaves like the tuple (lower_bound, upper_bound)
+        self.assertEqual(window, (3, 7))
+        self.assertEqual((3, 7), window)
+        self.assertNotEqual(window, (3, 8))
+        self.assertEqual(window, kodo.slide.Range((3, 7)))
+        self.assertEqual(hash(window), hash((3, 7)))
+        lower_bound, upper_bound = window
+        self.assertEqual((lower_bound, upper_bound), (3, 7))
+        self.assertEqual(window[-1], 7)
+        self.assertEqual(window[:1], (3,))
+        self.assertEqual(window[::-1], (7, 3))
+        self.assertEqual(window + (9,), (3, 7, 9))
+        self.assertEqual((1,) + window, (1, 3, 7))
+        self.assertEqual(tuple(window), (3, 7))
+        self.assertEqual(pickle.loads(pickle.dumps(window)), window)
+        self.assertIsInstance(pickle.loads(pickle.dumps(window)), kodo.slide.Range)
+        self.assertEqual(repr(window), "Range(3, 7)")
+
+        with self.assertRaises(ValueError):
+            kodo.slide.Range(7, 3)
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 10
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+        for _ in range(4):
+            encoder.push_symbol(os.urandom(max_symbol_bytes))
+
+        stream = encoder.stream_range
+        self.assertIsInstance(stream, kodo.slide.Range)
+        self.assertEqual(stream, (0, 4))
+
+        # Range and tuple windows give the same result
+        generator = kodo.slide.generator.RandomUniform(field)
+        generator.set_seed(1)
+        coefficients = generator.generate(stream)
+        generator.set_seed(1)
+        self.assertEqual(coefficients, generator.generate((0, 4)))
+        self.assertEqual(
+            encoder.encode_symbol(stream, coefficients),
+            encoder.encode_symbol((0, 4), coefficients),
+        )
+
+        with self.assertRaises(TypeError):
+            encoder.encode_symbol([0, 4], coefficients)
+
+    def test_slide_adaptive_rate_controller(self):
+
+        rate = kodo.slide.AdaptiveRateController(
+            min_window=8,
+            max_window=64,
+            smoothing=1.0,
+            margin=0.0,
+            initial_loss=0.0,
+        )
+
+        # Without loss no repair symbols are sent
+        self.assertEqual(rate.repair_ratio, 0.0)
+        for _ in range(100):
+            self.assertFalse(rate.send_repair())
+            rate.advance()
+        self.assertEqual(rate.source_symbols, 100)
+
+        # A loss of 20% needs one repair symbol per four source symbols
+        rate.feedback(decoded_upper_bound=100, loss=0.2)
+        self.assertAlmostEqual(rate.loss, 0.2)
+        self.assertAlmostEqual(rate.repair_ratio, 0.25)
+        self.assertEqual(rate.window_symbols, 8)
+
+        repairs = 0
+        for _ in range(500):
+            repairs += rate.send_repair()
+            rate.advance()
+        self.assertEqual(rate.repair_symbols, repairs)
+        self.assertEqual(repairs, 100)
+
+        # Missing symbols are repaired right away and the window covers
+        # the symbols the receiver has not decoded
+        rate.feedback(
+            decoded_upper_bound=rate.source_symbols - 40, loss=0.2, rank_gap=3
+        )
+        self.assertEqual(rate.window_symbols, 40)
+        for _ in range(3):
+            self.assertTrue(rate.send_repair())
+            rate.advance()
+
+        # A gap reported with a larger lag is bounded by the new window
+        rate = kodo.slide.AdaptiveRateController(
+            min_window=8, max_window=64, smoothing=1.0, margin=0.0, initial_loss=0.2
+        )
+        self.assertEqual(rate.window_symbols, 8)
+        while rate.source_symbols < 40:
+            rate.advance()
+        rate.feedback(decoded_upper_bound=0, loss=0.2, rank_gap=20)
+        self.assertEqual(rate.window_symbols, 40)
+        repairs = 0
+        while rate.send_repair():
+            repairs += 1
+            rate.advance()
+        self.assertEqual(repairs, 20)
+
+        with self.assertRaises(ValueError):
+            kodo.slide.AdaptiveRateController(min_window=10, max_window=5)
+
+    def test_slide_decoder_deliver_symbols(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 10
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+
+        decoder = kodo.slide.Decoder(field)
+        decoder.configure(max_symbol_bytes, capacity=16)
+        decoder.configure_delivery(max_gap=4)
+
+        def send(index):
+            decoder.advance_to(index + 1)
+            symbol = encoder.encode_systematic_symbol(index)
+            decoder.decode_systematic_symbol(symbol, index)
+
+        for _ in range(10):
+            encoder.push_symbol(os.urandom(max_symbol_bytes))
+
+        send(0)
+        send(1)
+        delivered = decoder.deliver_symbols()
+        self.assertEqual([index for index, _ in delivered], [0, 1])
+        self.assertEqual(delivered[1][1], encoder.symbol_data(1))
+
+        # Symbol 2 is lost, delivery waits for it
+        send(3)
+        send(4)
+        self.assertEqual(decoder.deliver_symbols(), [])
+        self.assertEqual(decoder.delivery_index, 2)
+
+        # Once it holds back more than max_gap symbols it is skipped
+        send(5)
+        send(6)
+        delivered = decoder.deliver_symbols()
+        self.assertEqual([index for index, _ in delivered], [3, 4, 5, 6])
+        self.assertEqual(decoder.skipped_symbols, 1)
+
+        # Without limits only symbols leaving the stream are skipped
+        decoder.configure_delivery()
+        send(8)
+        self.assertEqual(decoder.deliver_symbols(), [])
+        decoder.advance_to(30)
+        self.assertEqual(decoder.deliver_symbols(), [])
+        self.assertEqual(decoder.delivery_index, 14)
+        self.assertEqual(decoder.skipped_symbols, 1 + 7)
+
+        with self.assertRaises(ValueError):
+            decoder.configure_delivery(max_gap=0)
+
+    def test_slide_decoder_deliver_symbols_max_hold(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 10
+        max_hold = 0.05
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+        for _ in range(10):
+            encoder.push_symbol(os.urandom(max_symbol_bytes))
+
+        decoder = kodo.slide.Decoder(field)
+        decoder.configure(max_symbol_bytes, capacity=16)
+        decoder.configure_delivery(max_hold=max_hold)
+
+        def send(index):
+            decoder.advance_to(index + 1)
+            symbol = encoder.encode_systematic_symbol(index)
+            decoder.decode_systematic_symbol(symbol, index)
+
+        # Symbols 1 and 2 are lost, delivery waits for max_hold
+        send(0)
+        decoder.advance_to(3)
+        self.assertEqual([index for index, _ in decoder.deliver_symbols()], [0])
+        time.sleep(2 * max_hold)
+
+        # Symbol 1 is skipped, symbol 2 has nothing behind it yet
+        self.assertEqual(decoder.deliver_symbols(), [])
+        self.assertEqual(decoder.delivery_index, 2)
+        self.assertEqual(decoder.skipped_symbols, 1)
+
+        # The second hole gets its own hold time
+        send(3)
+        send(4)
+        self.assertEqual(decoder.deliver_symbols(), [])
+        self.assertEqual(decoder.delivery_index, 2)
+
+        time.sleep(2 * max_hold)
+        delivered = decoder.deliver_symbols()
+        self.assertEqual([index for index, _ in delivered], [3, 4])
+        self.assertEqual(decoder.skipped_symbols, 2)
+
+    def test_slide_encoder_push_symbols(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 100
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+        encoder.push_symbol(os.urandom(max_symbol_bytes))
+
+        lengths = [100, 1, 37, 64]
+        symbols = os.urandom(sum(lengths))
+
+        window = encoder.push_symbols(symbols, lengths)
+        self.assertEqual(window, (1, 5))
+        self.assertEqual(encoder.stream_range, (0, 5))
+
+        offset = 0
+        for index, length in zip(range(1, 5), lengths):
+            self.assertEqual(
+                encoder.symbol_data(index), symbols[offset : offset + length]
+            )
+            offset += length
+
+        # Nothing is pushed if the lengths are invalid
+        with self.assertRaises(ValueError):
+            encoder.push_symbols(symbols, [100, 1, 37])
+        with self.assertRaises(ValueError):
+            encoder.push_symbols(os.urandom(101), [101])
+        self.assertEqual(encoder.stream_upper_bound, 5)
+
+    def test_slide_feedback(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 10
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+
+        decoder = kodo.slide.Decoder(field)
+        decoder.configure(max_symbol_bytes, capacity=64)
+
+        for _ in range(20):
+            encoder.push_symbol(os.urandom(max_symbol_bytes))
+        decoder.advance_to(encoder.stream_upper_bound)
+
+        # Symbols 0 to 9 and 12 arrive
+        for index in list(range(10)) + [12]:
+            symbol = encoder.encode_systematic_symbol(index)
+            decoder.decode_systematic_symbol(symbol, index)
+
+        feedback = decoder.feedback()
+
+        # Two varints and two bitmaps of 10 bits
+        self.assertEqual(len(feedback), 1 + 1 + 2 + 2)
+        self.assertEqual(feedback[0], 10)
+        self.assertEqual(feedback[1], 10)
+
+        # The decoded symbols are popped and the rest are still needed
+        self.assertEqual(encoder.apply_feedback(feedback), 9)
+        self.assertEqual(encoder.stream_range, (10, 20))
+
+        # Applying old feedback again does nothing
+        self.assertEqual(encoder.apply_feedback(feedback), 9)
+        self.assertEqual(encoder.stream_range, (10, 20))
+
+        # Repair symbols are coded over the smaller window
+        window = encoder.stream_range
+        generator = kodo.slide.generator.RandomUniform(field)
+        for seed in range(9):
+            generator.set_seed(seed)
+            coefficients = generator.generate(window)
+            symbol = encoder.encode_symbol(window, coefficients)
+            decoder.decode_symbol(symbol, window, coefficients)
+
+        for index in range(10, 20):
+            if decoder.is_symbol_decoded(index):
+                self.assertEqual(
+                    decoder.symbol_data(index), encoder.symbol_data(index)
+                )
+
+        with self.assertRaises(ValueError):
+            encoder.apply_feedback(feedback[:-1])
+
+    def test_slide_encoder_encode_repairs(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 100
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+        for _ in range(32):
+            encoder.push_symbol(os.urandom(max_symbol_bytes))
+
+        generator = kodo.slide.generator.RandomUniform(field)
+        window = kodo.slide.Range(4, 32)
+        seeds = [3, 1, 4, 1, 5]
+
+        repairs = encoder.encode_repairs(generator, window, seeds)
+        self.assertEqual(len(repairs), len(seeds))
+
+        # The same as encoding the repair symbols one by one
+        for seed, repair in zip(seeds, repairs):
+            generator.set_seed(seed)
+            coefficients = generator.generate(window)
+            self.assertEqual(repair, encoder.encode_symbol(window, coefficients))
+
+        self.assertEqual(encoder.encode_repairs(generator, window, []), [])
+
+        with self.assertRaises(ValueError):
+            encoder.encode_repairs(generator, (30, 40), seeds)
+        with self.assertRaises(ValueError):
+            other = kodo.slide.generator.RandomUniform(kodo.FiniteField.binary)
+            encoder.encode_repairs(other, window, seeds)
+
+    def test_slide_decoder_deadline(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 10
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+        for _ in range(20):
+            encoder.push_symbol(os.urandom(max_symbol_bytes))
+
+        decoder = kodo.slide.Decoder(field)
+        decoder.configure(max_symbol_bytes, capacity=64)
+
+        expired = []
+        decoder.on_symbol_expired(lambda index: expired.append(index))
+
+        # A deadline in stream indices
+        decoder.configure_deadline(max_symbols=4)
+        decoder.advance_to(3)
+        symbol = encoder.encode_systematic_symbol(0)
+        decoder.decode_systematic_symbol(symbol, 0)
+        decoder.advance_to(6)
+        self.assertEqual(decoder.stream_range, (2, 6))
+
+        # Only the undecoded symbols are reported
+        self.assertEqual(expired, [1])
+        self.assertEqual(decoder.expired_symbols, 1)
+
+        # A deadline in seconds from the supplied timestamps
+        decoder.configure_deadline(max_age=0.5)
+        decoder.advance_to(8, timestamp=10.0)
+        decoder.advance_to(10, timestamp=10.4)
+        self.assertEqual(decoder.stream_range, (2, 10))
+
+        decoder.expire_symbols(now=10.5)
+        self.assertEqual(decoder.stream_range, (8, 10))
+        self.assertEqual(expired, [1, 2, 3, 4, 5, 6, 7])
+
+        decoder.push_symbol(timestamp=11.0)
+        self.assertEqual(decoder.stream_range, (10, 11))
+        self.assertEqual(decoder.expired_symbols, 9)
+
+        with self.assertRaises(ValueError):
+            decoder.configure_deadline(max_age=0)
+
+
+    def test_slide_symbol_data(self):
+
+        field = kodo.FiniteField.binary8
+        max_symbol_bytes = 100
+
+        encoder = kodo.slide.Encoder(field)
+        encoder.configure(max_symbol_bytes)
+
+        decoder = kodo.slide.Decoder(field)
+        decoder.configure(max_symbol_bytes)
+
+        symbol = bytearray(os.urandom(max_symbol_bytes))
+        encoder.push_symbol(symbol)
+        self.assertEqual(symbol, encoder.symbol_data(0))
+
+        decoder.push_symbol()
+        decoder.decode_systematic_symbol(encoder.encode_systematic_symbol(0), 0)
+        self.assertEqual(symbol, decoder.symbol_data(0))
+        self.assertIsNone(decoder.symbol_data(1))
 
 if __name__ == "__main__":
     unittest.main()
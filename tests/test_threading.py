@@ -0,0 +1,220 @@
+#!/usr/bin/env python
+# encoding: utf-8
+
+"""Tests coding with independent coders in multiple threads and on the
+native executor"""
+
+# License for Commercial Usage
+# Distributed under the "KODO EVALUATION LICENSE 1.3"
+# Licensees holding a valid commercial license may use this project in
+# accordance with the standard license agreement terms provided with the
+# Software (see accompanying file LICENSE.rst or
+# https://www.steinwurf.com/license), unless otherwise different terms and
+# conditions are agreed in writing between Licensee and Steinwurf ApS in which
+# case the license will be regulated by that separate written agreement.
+# License for Non-Commercial Usage
+# Distributed under the "KODO RESEARCH LICENSE 1.2"
+# Licensees holding a valid research license may use this project in accordance
+# with the license agreement terms provided with the Software
+# See accompanying file LICENSE.rst or https://www.steinwurf.com/license
+
+import os
+import threading
+import unittest
+
+import kodo
+
+
+def block_encode_decode(field, symbols, symbol_bytes, generations):
+    """Encode and decode a number of generations with a private set of coders.
+    Return True if all generations were decoded correctly."""
+
+    encoder = kodo.block.Encoder(field)
+    decoder = kodo.block.Decoder(field)
+    generator = kodo.block.generator.RandomUniform(field)
+
+    for generation in range(generations):
+        encoder.configure(symbols, symbol_bytes)
+        decoder.configure(symbols, symbol_bytes)
+        generator.configure(symbols)
+        generator.set_seed(generation)
+
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        while not decoder.is_complete():
+            coefficients = generator.generate()
+            symbol = encoder.encode_symbol(coefficients)
+            decoder.decode_symbol(symbol, coefficients)
+
+        if data_in != data_out:
+            return False
+
+    return True
+
+
+class TestThreading(unittest.TestCase):
+
+    field = kodo.FiniteField.binary8
+    symbols = 64
+    symbol_bytes = 1024
+    generations = 2
+
+    def test_block_threaded(self):
+
+        # Independent coders used from several threads at once, with the GIL
+        # released while they code, must all decode correctly
+        threads = max(2, min(os.cpu_count() or 1, 8))
+        results = [False] * threads
+
+        def session(index):
+            results[index] = block_encode_decode(
+                self.field, self.symbols, self.symbol_bytes, self.generations
+            )
+
+        workers = [
+            threading.Thread(target=session, args=(index,))
+            for index in range(threads)
+        ]
+        for worker in workers:
+            worker.start()
+        for worker in workers:
+            worker.join()
+
+        self.assertTrue(all(results))
+
+    def test_executor_block(self):
+
+        field = kodo.FiniteField.binary8
+        symbols = 16
+        symbol_bytes = 1024
+        sessions = 32
+
+        executor = kodo.Executor(4)
+        self.assertEqual(4, executor.threads)
+
+        generator = kodo.block.generator.RandomUniform(field)
+        generator.configure(symbols)
+
+        coders = []
+        for _ in range(sessions):
+            encoder = kodo.block.Encoder(field)
+            encoder.configure(symbols, symbol_bytes)
+            data_in = bytearray(os.urandom(encoder.block_bytes))
+            encoder.set_symbols_storage(data_in)
+
+            decoder = kodo.block.Decoder(field)
+            decoder.configure(symbols, symbol_bytes)
+            data_out = bytearray(decoder.block_bytes)
+            decoder.set_symbols_storage(data_out)
+
+            coders.append((encoder, decoder, data_in, data_out))
+
+        # Submit the encode jobs of all sessions, then decode the results.
+        # Jobs of the same coder run in order, so the decode jobs of a
+        # session need not be waited for before submitting the next.
+        while not all(decoder.is_complete() for _, decoder, _, _ in coders):
+            encoded = []
+            for encoder, decoder, _, _ in coders:
+                if decoder.is_complete():
+                    continue
+                coefficients = generator.generate()
+                future = executor.encode(encoder, coefficients)
+                encoded.append((decoder, coefficients, future))
+
+            decoded = [
+                executor.decode(decoder, future.result(), coefficients)
+                for decoder, coefficients, future in encoded
+            ]
+            for future in decoded:
+                self.assertIsNone(future.result(timeout=10))
+                self.assertTrue(future.done())
+
+        for _, _, data_in, data_out in coders:
+            self.assertEqual(data_in, data_out)
+
+    def test_executor_recode(self):
+
+        field = kodo.FiniteField.binary8
+        symbols = 16
+        symbol_bytes = 1024
+
+        executor = kodo.Executor()
+
+        encoder = kodo.block.Encoder(field)
+        encoder.configure(symbols, symbol_bytes)
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        relay = kodo.block.Decoder(field)
+        relay.configure(symbols, symbol_bytes)
+        relay.set_symbols_storage(bytearray(relay.block_bytes))
+
+        decoder = kodo.block.Decoder(field)
+        decoder.configure(symbols, symbol_bytes)
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        generator = kodo.block.generator.RandomUniform(field)
+        generator.configure(symbols)
+
+        while not relay.is_complete():
+            coefficients = generator.generate()
+            symbol = executor.encode(encoder, coefficients).result()
+            executor.decode(relay, symbol, coefficients).result()
+
+        while not decoder.is_complete():
+            coefficients_in = generator.generate_recode(relay)
+            coefficients = bytearray(len(coefficients_in))
+            future = executor.recode(relay, coefficients_in, coefficients)
+            symbol = future.result()
+            executor.decode(decoder, symbol, coefficients).result()
+
+        self.assertEqual(data_in, data_out)
+
+    def test_executor_perpetual(self):
+
+        width = kodo.perpetual.Width._32
+        symbol_bytes = 1024
+        block_bytes = 100000
+
+        executor = kodo.Executor(2)
+
+        encoder = kodo.perpetual.Encoder(width)
+        encoder.configure(block_bytes, symbol_bytes)
+        data_in = bytearray(os.urandom(encoder.block_bytes))
+        encoder.set_symbols_storage(data_in)
+
+        decoder = kodo.perpetual.Decoder(width)
+        decoder.configure(block_bytes, symbol_bytes)
+        data_out = bytearray(decoder.block_bytes)
+        decoder.set_symbols_storage(data_out)
+
+        generator = kodo.perpetual.generator.RandomUniform(width)
+        offset_generator = kodo.perpetual.offset.RandomUniform()
+        offset_generator.configure(encoder.symbols)
+
+        seed = 0
+        while not decoder.is_complete():
+            offset = offset_generator.offset()
+            coefficients = generator.generate(seed)
+            symbol = executor.encode(encoder, coefficients, offset).result()
+            executor.decode(decoder, symbol, coefficients, offset).result()
+            seed += 1
+
+        self.assertEqual(data_in, data_out)
+
+        # Symbols decoded on the executor are counted by stats()
+        stats = decoder.stats()
+        self.assertEqual(seed, stats["symbols_received"])
+        self.assertIsNotNone(stats["mapping_rank"])
+
+        with self.assertRaises(ValueError):
+            executor.encode(encoder, 0, encoder.symbols)
+
+
+if __name__ == "__main__":
+    unittest.main()